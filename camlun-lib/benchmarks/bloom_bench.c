@@ -0,0 +1,108 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "hashmap.h"
+#include "treeset.h"
+#include "typemethods.h"
+
+// Miss heavy lookups with and without an attached Bloom filter : 90% of the queries are ids
+// never inserted. The string map has had half its keys removed, leaving its tables full of tombstones.
+
+static type_methods TYPE_INT = TYPE_METHODS(int);
+static type_methods TYPE_STRING = TYPE_METHODS(string);
+
+static const int KEY_COUNT = 1 << 17;
+static const int QUERY_COUNT = 1 << 21;
+
+static double now_seconds() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+static uint32_t next_random(uint32_t *state) {
+    *state ^= *state << 13;
+    *state ^= *state >> 17;
+    *state ^= *state << 5;
+    return *state;
+}
+
+// Query i of the trace, a present key one time in ten
+static int query_key(uint32_t *state) {
+    uint32_t r = next_random(state);
+    int key = (int)(r % KEY_COUNT);
+    return r % 10 == 0 ? key : key + KEY_COUNT;
+}
+
+static char (*make_ids(void))[16] {
+    char (*ids)[16] = malloc(2 * (size_t)KEY_COUNT * sizeof(*ids));
+    for (int i = 0; i < 2 * KEY_COUNT; i++) {
+        snprintf(ids[i], sizeof(ids[i]), "%d,%d", i / 512, i % 512);
+    }
+    return ids;
+}
+
+static double bench_string_map(char (*ids)[16], bool filtered, size_t *found) {
+    HashMap *map = hashmap_create(&TYPE_STRING, &TYPE_INT);
+    for (int i = 0; i < KEY_COUNT; i++) {
+        hashmap_set(map, ids[i], &i);
+    }
+    // Removing the odd ids leaves tombstones along the probe sequences of the misses
+    for (int i = 1; i < KEY_COUNT; i += 2) {
+        hashmap_remove(map, ids[i]);
+    }
+    if (filtered) {
+        hashmap_attach_filter(map, 0.01);
+    }
+    uint32_t state = 0x9E3779B9u;
+    *found = 0;
+    double start = now_seconds();
+    for (int i = 0; i < QUERY_COUNT; i++) {
+        *found += hashmap_contains(map, ids[query_key(&state)]);
+    }
+    double elapsed = now_seconds() - start;
+    hashmap_destroy(map);
+    return QUERY_COUNT / elapsed;
+}
+
+static double bench_treeset(bool filtered, size_t *found) {
+    TreeSet *set = treeset_create(&TYPE_INT);
+    for (int i = 0; i < KEY_COUNT; i++) {
+        treeset_add(set, &i);
+    }
+    if (filtered) {
+        treeset_attach_filter(set, 0.01);
+    }
+    uint32_t state = 0x9E3779B9u;
+    *found = 0;
+    double start = now_seconds();
+    for (int i = 0; i < QUERY_COUNT; i++) {
+        int key = query_key(&state);
+        *found += treeset_contains(set, &key);
+    }
+    double elapsed = now_seconds() - start;
+    treeset_destroy(set);
+    return QUERY_COUNT / elapsed;
+}
+
+int main() {
+    char (*ids)[16] = make_ids();
+    size_t plain_found, filtered_found;
+    printf("%-24s %12s %12s\n", "90% misses", "plain", "filtered");
+
+    double plain = bench_string_map(ids, false, &plain_found);
+    double filtered = bench_string_map(ids, true, &filtered_found);
+    printf("%-24s %9.2f M/s %9.2f M/s%s\n", "string HashMap", plain / 1e6, filtered / 1e6,
+           plain_found == filtered_found ? "" : "  (results differ)");
+
+    plain = bench_treeset(false, &plain_found);
+    filtered = bench_treeset(true, &filtered_found);
+    printf("%-24s %9.2f M/s %9.2f M/s%s\n", "int TreeSet", plain / 1e6, filtered / 1e6,
+           plain_found == filtered_found ? "" : "  (results differ)");
+    free(ids);
+    return 0;
+}
@@ -0,0 +1,98 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include <pthread.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "concurrenthashmap.h"
+#include "typemethods.h"
+
+// Mixed workload : 90% lookups and 10% writes over a preloaded key range,
+// run with 1 thread up to the number of online cores, for one shard and for the default.
+
+static type_methods TYPE_INT = TYPE_METHODS(int);
+
+static const int KEY_RANGE = 1 << 16;
+static const int OPERATIONS_PER_THREAD = 1 << 20;
+
+typedef struct {
+    ConcurrentHashMap *map;
+    unsigned int seed;
+} bench_args;
+
+static double now_seconds() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+// xorshift keeps the generator out of the measurement and free of shared state
+static uint32_t next_random(uint32_t *state) {
+    *state ^= *state << 13;
+    *state ^= *state >> 17;
+    *state ^= *state << 5;
+    return *state;
+}
+
+static void *bench_worker(void *arg) {
+    bench_args *args = arg;
+    uint32_t state = args->seed;
+    for (int i = 0; i < OPERATIONS_PER_THREAD; i++) {
+        uint32_t r = next_random(&state);
+        int key = (int)(r % KEY_RANGE);
+        if (r >> 28 == 0) {
+            concurrenthashmap_set(args->map, &key, &i);
+        } else {
+            int *value = concurrenthashmap_get(args->map, &key);
+            int_destructor(value);
+        }
+    }
+    return NULL;
+}
+
+static double bench_run(size_t shard_count, int thread_count) {
+    ConcurrentHashMap *map = concurrenthashmap_create(&TYPE_INT, &TYPE_INT, shard_count);
+    for (int key = 0; key < KEY_RANGE; key++) {
+        concurrenthashmap_set(map, &key, &key);
+    }
+
+    pthread_t *threads = malloc(thread_count * sizeof(pthread_t));
+    bench_args *args = malloc(thread_count * sizeof(bench_args));
+    double start = now_seconds();
+    for (int i = 0; i < thread_count; i++) {
+        args[i] = (bench_args){.map = map, .seed = 0x9E3779B9u * (i + 1)};
+        pthread_create(&threads[i], NULL, bench_worker, &args[i]);
+    }
+    for (int i = 0; i < thread_count; i++) {
+        pthread_join(threads[i], NULL);
+    }
+    double elapsed = now_seconds() - start;
+
+    free(threads);
+    free(args);
+    concurrenthashmap_destroy(map);
+    return (double)OPERATIONS_PER_THREAD * thread_count / elapsed;
+}
+
+int main() {
+    long cores = sysconf(_SC_NPROCESSORS_ONLN);
+    if (cores < 1) {
+        cores = 1;
+    }
+    printf("%8s %12s %12s\n", "threads", "1 shard", "sharded");
+    // Doubling thread counts, always ending on the core count
+    int threads = 1;
+    while (1) {
+        double single = bench_run(1, threads);
+        double sharded = bench_run(0, threads);
+        printf("%8d %9.2f M/s %9.2f M/s\n", threads, single / 1e6, sharded / 1e6);
+        if (threads >= cores) {
+            break;
+        }
+        threads = threads * 2 < cores ? threads * 2 : (int)cores;
+    }
+    return 0;
+}
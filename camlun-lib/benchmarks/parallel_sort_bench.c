@@ -0,0 +1,79 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "vector.h"
+#include "vector_ext.h"
+#include "typemethods.h"
+
+// Scaling of vector_sort_parallel on 4M random elements from one thread up to at least the online cores.
+// Compared ints wrap the comparator so every chunk is sorted by comparisons, doubles are radix sorted per chunk.
+
+static int compared_int_comparator(void *first, void *second) {
+    return int_comparator(first, second);
+}
+
+static type_methods TYPE_COMPARED_INT = {.cmp = compared_int_comparator};
+static type_methods TYPE_DOUBLE = TYPE_METHODS(double);
+
+static const size_t VALUE_COUNT = 1 << 22;
+
+static double now_seconds() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+static uint64_t next_random(uint64_t *state) {
+    *state ^= *state << 13;
+    *state ^= *state >> 7;
+    *state ^= *state << 17;
+    return *state;
+}
+
+static Vector *create_input(bool radix) {
+    Vector *vector = radix ? vector_create_sized(sizeof(double), &TYPE_DOUBLE) : vector_create_sized(sizeof(int), &TYPE_COMPARED_INT);
+    vector_reserve(vector, VALUE_COUNT);
+    uint64_t state = 0x9E3779B97F4A7C15u;
+    for (size_t i = 0; i < VALUE_COUNT; i++) {
+        uint64_t r = next_random(&state);
+        if (radix) {
+            vector_push_back(vector, &(double){(double)(int64_t)r / 1e9});
+        } else {
+            vector_push_back(vector, &(int){(int)(r >> 33)});
+        }
+    }
+    return vector;
+}
+
+static double time_sort(bool radix, size_t thread_count) {
+    Vector *vector = create_input(radix);
+    double start = now_seconds();
+    vector_sort_parallel(vector, false, thread_count);
+    double elapsed = now_seconds() - start;
+    vector_destroy(vector);
+    return elapsed;
+}
+
+int main() {
+    long cores = sysconf(_SC_NPROCESSORS_ONLN);
+    size_t max_threads = cores > 4 ? (size_t)cores : 4;
+    printf("%ld online cores\n", cores);
+    printf("%-10s %14s %9s %14s %9s\n", "threads", "compared, ms", "speedup", "radix, ms", "speedup");
+    double compared_base = 0;
+    double radix_base = 0;
+    for (size_t threads = 1; threads <= max_threads; threads *= 2) {
+        double compared = time_sort(false, threads);
+        double radix = time_sort(true, threads);
+        if (threads == 1) {
+            compared_base = compared;
+            radix_base = radix;
+        }
+        printf("%-10zu %14.1f %8.2fx %14.1f %8.2fx\n", threads, compared * 1e3, compared_base / compared, radix * 1e3, radix_base / radix);
+    }
+    return 0;
+}
@@ -0,0 +1,130 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "vector.h"
+#include "vector_ext.h"
+#include "typemethods.h"
+#include "tuple.h"
+
+// Radix sorting 4M numeric keys against comparison sorting through the same Vector, and libc qsort on a plain
+// array. The comparison vectors wrap the comparator so vector_sort does not take the radix path for them.
+
+static type_methods TYPE_UINT64 = TYPE_METHODS(uint64_t);
+static type_methods TYPE_DOUBLE = TYPE_METHODS(double);
+
+static int compared_uint64_comparator(void *first, void *second) {
+    return uint64_t_comparator(first, second);
+}
+
+static int compared_double_comparator(void *first, void *second) {
+    return double_comparator(first, second);
+}
+
+static type_methods TYPE_COMPARED_UINT64 = {.cmp = compared_uint64_comparator};
+static type_methods TYPE_COMPARED_DOUBLE = {.cmp = compared_double_comparator};
+
+TUPLE_INIT(static type_methods TYPE_SAMPLE, double value; uint32_t id;, sample, {
+    return VALUE_COMPARE(double, _first->value, _second->value);
+})
+
+static uint64_t sample_key(void *element) {
+    return radix_key_double(((sample *)element)->value);
+}
+
+static const size_t VALUE_COUNT = 1 << 22;
+
+static double now_seconds() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+static uint64_t next_random(uint64_t *state) {
+    *state ^= *state << 13;
+    *state ^= *state >> 7;
+    *state ^= *state << 17;
+    return *state;
+}
+
+static int qsort_uint64_comparator(const void *first, const void *second) {
+    return uint64_t_comparator((void *)first, (void *)second);
+}
+
+static int qsort_double_comparator(const void *first, const void *second) {
+    return double_comparator((void *)first, (void *)second);
+}
+
+static Vector *fill_vector(Vector *vector, void *values, size_t element_size) {
+    vector_reserve(vector, VALUE_COUNT);
+    for (size_t i = 0; i < VALUE_COUNT; i++) {
+        vector_push_back(vector, (unsigned char *)values + i * element_size);
+    }
+    return vector;
+}
+
+static double time_qsort(void *values, size_t element_size, int (*cmp)(const void *, const void *)) {
+    void *copy = malloc(VALUE_COUNT * element_size);
+    memcpy(copy, values, VALUE_COUNT * element_size);
+    double start = now_seconds();
+    qsort(copy, VALUE_COUNT, element_size, cmp);
+    double elapsed = now_seconds() - start;
+    free(copy);
+    return elapsed;
+}
+
+static double time_sort(Vector *vector, bool radix) {
+    double start = now_seconds();
+    if (radix) {
+        vector_radix_sort(vector, false);
+    } else {
+        vector_sort(vector, false);
+    }
+    double elapsed = now_seconds() - start;
+    vector_destroy(vector);
+    return elapsed;
+}
+
+int main() {
+    uint64_t state = 0x9E3779B97F4A7C15u;
+    uint64_t *integers = malloc(VALUE_COUNT * sizeof(uint64_t));
+    double *doubles = malloc(VALUE_COUNT * sizeof(double));
+    sample *samples = malloc(VALUE_COUNT * sizeof(sample));
+    for (size_t i = 0; i < VALUE_COUNT; i++) {
+        integers[i] = next_random(&state);
+        doubles[i] = (double)(int64_t)next_random(&state) / 1e9;
+        samples[i] = (sample){.value = doubles[i], .id = (uint32_t)i};
+    }
+
+    printf("%-18s %10s %10s %10s\n", "4M keys, ms", "qsort", "vector", "radix");
+    printf("%-18s %10.1f %10.1f %10.1f\n", "uint64_t",
+           time_qsort(integers, sizeof(uint64_t), qsort_uint64_comparator) * 1e3,
+           time_sort(fill_vector(vector_create_sized(sizeof(uint64_t), &TYPE_COMPARED_UINT64), integers, sizeof(uint64_t)), false) * 1e3,
+           time_sort(fill_vector(vector_create_sized(sizeof(uint64_t), &TYPE_UINT64), integers, sizeof(uint64_t)), true) * 1e3);
+    printf("%-18s %10.1f %10.1f %10.1f\n", "double",
+           time_qsort(doubles, sizeof(double), qsort_double_comparator) * 1e3,
+           time_sort(fill_vector(vector_create_sized(sizeof(double), &TYPE_COMPARED_DOUBLE), doubles, sizeof(double)), false) * 1e3,
+           time_sort(fill_vector(vector_create_sized(sizeof(double), &TYPE_DOUBLE), doubles, sizeof(double)), true) * 1e3);
+
+    Vector *by_comparator = fill_vector(vector_create_sized(sizeof(sample), &TYPE_SAMPLE), samples, sizeof(sample));
+    Vector *by_key = fill_vector(vector_create_sized(sizeof(sample), &TYPE_SAMPLE), samples, sizeof(sample));
+    double start = now_seconds();
+    vector_stable_sort(by_comparator, false);
+    double compared = now_seconds() - start;
+    start = now_seconds();
+    vector_radix_sort_by(by_key, sample_key, false);
+    double keyed = now_seconds() - start;
+    bool same = memcmp(by_comparator->nodes, by_key->nodes, VALUE_COUNT * sizeof(sample)) == 0;
+    printf("%-18s %10s %10.1f %10.1f%s\n", "tuple by double", "", compared * 1e3, keyed * 1e3, same ? "" : "  (results differ)");
+    vector_destroy(by_comparator);
+    vector_destroy(by_key);
+
+    free(integers);
+    free(doubles);
+    free(samples);
+    return 0;
+}
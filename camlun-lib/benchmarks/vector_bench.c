@@ -0,0 +1,117 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "vector.h"
+#include "vector_ext.h"
+#include "typemethods.h"
+
+// Boxed vectors hold a heap allocated copy of every double, sized vectors store the doubles back to back.
+// Fill pushes every value, scan sums them in order and heap offers then polls every value.
+// Filter drops every odd value of 32K, erasing one at a time against vector_erase_if.
+
+static type_methods TYPE_DOUBLE = TYPE_METHODS(double);
+
+static const int VALUE_COUNT = 1 << 20;
+static const int HEAP_COUNT = 1 << 18;
+static const int FILTER_COUNT = 1 << 15;
+
+static double now_seconds() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+static Vector *create_vector(bool sized) {
+    return sized ? vector_create_sized(sizeof(double), &TYPE_DOUBLE) : vector_create(&TYPE_DOUBLE);
+}
+
+static void bench_vector(bool sized, double *fill_rate, double *scan_rate, double *sum) {
+    Vector *vector = create_vector(sized);
+    double start = now_seconds();
+    for (int i = 0; i < VALUE_COUNT; i++) {
+        vector_push_back(vector, &(double){i * 0.25});
+    }
+    *fill_rate = VALUE_COUNT / (now_seconds() - start);
+
+    *sum = 0;
+    double *value;
+    start = now_seconds();
+    for (int round = 0; round < 8; round++) {
+        VECTOR_FOREACH(vector, value, { *sum += *value; });
+    }
+    *scan_rate = 8.0 * VALUE_COUNT / (now_seconds() - start);
+    vector_destroy(vector);
+}
+
+static double bench_heap(bool sized, double *checksum) {
+    Vector *heap = create_vector(sized);
+    double start = now_seconds();
+    for (int i = 0; i < HEAP_COUNT; i++) {
+        heap_offer(heap, &(double){(double)((i * 7919) % HEAP_COUNT)}, false);
+    }
+    *checksum = 0;
+    for (int i = 0; i < HEAP_COUNT; i++) {
+        double top;
+        if (sized) {
+            heap_poll_into(heap, &top, false);
+        } else {
+            double *polled = heap_poll(heap, false);
+            top = *polled;
+            double_destructor(polled);
+        }
+        *checksum += top * i;
+    }
+    double elapsed = now_seconds() - start;
+    vector_destroy(heap);
+    return HEAP_COUNT / elapsed;
+}
+
+static bool is_odd(void *data, void *context) {
+    (void)context;
+    return (long)*(double *)data % 2 != 0;
+}
+
+static double bench_filter(bool sized, bool erase_if) {
+    Vector *vector = create_vector(sized);
+    for (int i = 0; i < FILTER_COUNT; i++) {
+        vector_push_back(vector, &(double){i});
+    }
+    double start = now_seconds();
+    if (erase_if) {
+        vector_erase_if(vector, is_odd, NULL);
+    } else {
+        for (size_t i = vector_size(vector); i-- > 0;) {
+            if (is_odd(vector_get(vector, i), NULL)) {
+                vector_erase(vector, i);
+            }
+        }
+    }
+    double elapsed = now_seconds() - start;
+    vector_destroy(vector);
+    return elapsed;
+}
+
+int main() {
+    double boxed_fill, boxed_scan, boxed_sum, sized_fill, sized_scan, sized_sum;
+    printf("%-24s %12s %12s\n", "1M doubles", "boxed", "sized");
+
+    bench_vector(false, &boxed_fill, &boxed_scan, &boxed_sum);
+    bench_vector(true, &sized_fill, &sized_scan, &sized_sum);
+    printf("%-24s %9.2f M/s %9.2f M/s\n", "push_back", boxed_fill / 1e6, sized_fill / 1e6);
+    printf("%-24s %9.2f M/s %9.2f M/s%s\n", "sequential scan", boxed_scan / 1e6, sized_scan / 1e6,
+           boxed_sum == sized_sum ? "" : "  (results differ)");
+
+    double boxed_checksum, sized_checksum;
+    double boxed_heap = bench_heap(false, &boxed_checksum);
+    double sized_heap = bench_heap(true, &sized_checksum);
+    printf("%-24s %9.2f M/s %9.2f M/s%s\n", "heap offer and poll", boxed_heap / 1e6, sized_heap / 1e6,
+           boxed_checksum == sized_checksum ? "" : "  (results differ)");
+
+    printf("%-24s %12s %12s\n", "filter 32K, ms", "boxed", "sized");
+    printf("%-24s %12.2f %12.2f\n", "erase one at a time", bench_filter(false, false) * 1e3, bench_filter(true, false) * 1e3);
+    printf("%-24s %12.2f %12.2f\n", "erase_if", bench_filter(false, true) * 1e3, bench_filter(true, true) * 1e3);
+    return 0;
+}
@@ -0,0 +1,69 @@
+#ifndef BLOOMFILTER_H
+#define BLOOMFILTER_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "typemethods.h"
+
+/**
+ * Constants
+ */
+
+#define BLOOMFILTER_BLOCK_BITS 512  // One cache line
+#define BLOOMFILTER_BLOCK_WORDS (BLOOMFILTER_BLOCK_BITS / 64)
+#define BLOOMFILTER_MAX_HASHES 16
+
+/**
+ * Type Structures
+ */
+
+// Blocked Bloom filter : the hash picks one cache line and every bit of the element is set
+// within it, so a query reads a single line. Elements cannot be removed, a filter that answers
+// false has never seen the element while true may be a false positive.
+typedef struct BloomFilter {
+    uint64_t *blocks;
+    size_t block_count;
+    size_t hash_count;  // Bits set per element
+    size_t capacity;    // Elements the filter was sized for
+    size_t size;        // Elements added, counting repeats
+    double false_positive_rate;
+    type_methods *data_methods;  // Supplies the hash of bloomfilter_add and bloomfilter_contains
+} BloomFilter;
+
+// ==== Method Overview ====
+
+// Private Methods :
+
+// uint64_t *bloomfilter_block(BloomFilter *filter, size_t hash);
+// size_t bloomfilter_next_bit(uint64_t *bits, size_t i);
+
+// Constructors and destructors :
+
+BloomFilter *bloomfilter_create(type_methods *data_methods, size_t expected_size, double false_positive_rate);
+BloomFilter *bloomfilter_clone(BloomFilter *filter);
+void bloomfilter_destroy(BloomFilter *filter);
+
+// Access :
+
+bool bloomfilter_contains(BloomFilter *filter, void *data);
+bool bloomfilter_contains_hash(BloomFilter *filter, size_t hash);
+
+// Capacity and tuning :
+
+size_t bloomfilter_size(BloomFilter *filter);
+size_t bloomfilter_capacity(BloomFilter *filter);
+size_t bloomfilter_bit_count(BloomFilter *filter);
+size_t bloomfilter_hash_count(BloomFilter *filter);
+double bloomfilter_estimated_false_positive_rate(BloomFilter *filter);
+
+// Modifiers :
+
+void bloomfilter_add(BloomFilter *filter, void *data);
+void bloomfilter_add_hash(BloomFilter *filter, size_t hash);
+void bloomfilter_clear(BloomFilter *filter);
+
+// ==== End of Method Overview ====
+
+#endif
@@ -0,0 +1,79 @@
+#ifndef CONCURRENTHASHMAP_H
+#define CONCURRENTHASHMAP_H
+
+#include <stdbool.h>
+#include <stddef.h>
+
+#include "hashmap.h"
+#include "typemethods.h"
+
+/**
+ * Constants
+ */
+
+// Shards used when 0 is passed to concurrenthashmap_create, a power of two
+static const size_t CONCURRENTHASHMAP_DEFAULT_SHARDS = 64;
+
+/**
+ * Type Structures
+ */
+
+// A HashMap and the reader-writer lock guarding it, defined in concurrenthashmap.c
+// so that this header does not depend on the POSIX feature macros.
+typedef struct ConcurrentHashMapShard ConcurrentHashMapShard;
+
+typedef struct ConcurrentHashMap {
+    ConcurrentHashMapShard *shards;
+    size_t shard_count;  // Power of two
+    size_t shard_bits;   // log2(shard_count), the shard is picked by the top shard_bits of the hash
+    type_methods *key_methods;
+    type_methods *value_methods;
+} ConcurrentHashMap;
+
+// ==== Method Overview ====
+
+// Private Methods :
+
+// size_t concurrenthashmap_shard_of(ConcurrentHashMap *map, size_t hash);
+
+// Constructors and destructors :
+
+ConcurrentHashMap *concurrenthashmap_create(type_methods *key_methods, type_methods *value_methods, size_t shard_count);
+void concurrenthashmap_destroy(ConcurrentHashMap *map);
+
+// Access and iteration :
+
+void *concurrenthashmap_get(ConcurrentHashMap *map, void *key);
+bool concurrenthashmap_contains(ConcurrentHashMap *map, void *key);
+
+HashMap *concurrenthashmap_read_lock(ConcurrentHashMap *map, size_t shard);
+void concurrenthashmap_read_unlock(ConcurrentHashMap *map, size_t shard);
+
+// Capacity :
+
+bool concurrenthashmap_empty(ConcurrentHashMap *map);
+size_t concurrenthashmap_size(ConcurrentHashMap *map);
+
+// Modifiers :
+
+void concurrenthashmap_add(ConcurrentHashMap *map, void *key);
+void concurrenthashmap_set(ConcurrentHashMap *map, void *key, void *value);
+void concurrenthashmap_remove(ConcurrentHashMap *map, void *key);
+
+// ==== End of Method Overview ====
+
+// ==== Macros ====
+
+// Visits one shard at a time under its read lock. Writers to other shards are not blocked,
+// so the pairs seen are a per-shard snapshot. The callback must not break out of the loop
+// or write to the map.
+#define CONCURRENTHASHMAP_PAIRS_FOREACH(map, keyname, valuename, callback)   \
+    do {                                                                     \
+        for (size_t _shard = 0; _shard < (map)->shard_count; _shard++) {     \
+            HashMap *_shard_map = concurrenthashmap_read_lock(map, _shard);  \
+            HASHMAP_PAIRS_FOREACH(_shard_map, keyname, valuename, callback); \
+            concurrenthashmap_read_unlock(map, _shard);                      \
+        }                                                                    \
+    } while (0)
+
+#endif
@@ -50,6 +50,7 @@ typedef struct Graph {
 
     size_t vertex_count;
     size_t edge_count;
+    size_t edge_capacity;  // Expected edge count, sizes the edges hashmap when it is built
 
 } Graph;
 
@@ -60,6 +61,7 @@ typedef struct Graph {
 // Constructors and destructors :
 
 Graph *graph_create(type_methods *id_methods, type_methods *value_methods);
+Graph *graph_create_with_capacity(type_methods *id_methods, type_methods *value_methods, size_t vertex_count, size_t edge_count);
 void graph_destroy(Graph *this);
 void graph_init_edges(Graph *this);
 void graph_uninit_edges(Graph *this);
@@ -0,0 +1,51 @@
+#ifndef HASHKERNEL_H
+#define HASHKERNEL_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+// Hash kernels for data of at most HASH_KERNEL_MAX_SIZE bytes. A wyhash style 64 x 64 -> 128 bit
+// multiply folded back to 64 bits replaces the block loop and tail handling of MurmurHash3,
+// which only pay off on longer data. Called with a constant size, a kernel inlines to one or two
+// loads and three multiplications. The kernels back the unseeded hashes only, they are no keyed hash:
+// data whose first 8 bytes equal HASH_KERNEL_P1 zeroes the inner product, whatever the seed.
+
+#define HASH_KERNEL_MAX_SIZE 16
+
+static const uint64_t HASH_KERNEL_P0 = 0xa0761d6478bd642fULL;
+static const uint64_t HASH_KERNEL_P1 = 0xe7037ed1a0b428dbULL;
+
+// High and low halves of the 128 bit product, xored
+static inline uint64_t hash_kernel_mum(uint64_t a, uint64_t b) {
+#ifdef __SIZEOF_INT128__
+    unsigned __int128 product = (unsigned __int128)a * b;
+    return (uint64_t)product ^ (uint64_t)(product >> 64);
+#else
+    uint64_t a_high = a >> 32, a_low = (uint32_t)a;
+    uint64_t b_high = b >> 32, b_low = (uint32_t)b;
+    uint64_t high = a_high * b_high, middle0 = a_high * b_low, middle1 = a_low * b_high, low = a_low * b_low;
+    uint64_t carry = ((low >> 32) + (uint32_t)middle0 + (uint32_t)middle1) >> 32;
+    uint64_t product_low = low + (middle0 << 32) + (middle1 << 32);
+    uint64_t product_high = high + (middle0 >> 32) + (middle1 >> 32) + carry;
+    return product_low ^ product_high;
+#endif
+}
+
+// Up to 8 bytes, zero extended
+static inline uint64_t hash_kernel_load(const unsigned char *bytes, size_t size) {
+    uint64_t value = 0;
+    memcpy(&value, bytes, size);
+    return value;
+}
+
+// size must be at most HASH_KERNEL_MAX_SIZE
+static inline uint64_t hash_kernel(const void *ptr, size_t size, uint64_t seed) {
+    const unsigned char *bytes = ptr;
+    uint64_t first = hash_kernel_load(bytes, size < 8 ? size : 8);
+    uint64_t second = size > 8 ? hash_kernel_load(bytes + 8, size - 8) : 0;
+    seed ^= hash_kernel_mum(seed ^ HASH_KERNEL_P0, HASH_KERNEL_P1);
+    return hash_kernel_mum(HASH_KERNEL_P1 ^ size, hash_kernel_mum(first ^ HASH_KERNEL_P1, second ^ seed));
+}
+
+#endif
@@ -2,60 +2,177 @@
 #define HASHMAP_H
 
 #include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
 
+#include "bloomfilter.h"
 #include "typemethods.h"
 
 /**
  * Constants
  */
 
-#define HASHMAP_NODE_FREE 0x00
-#define HASHMAP_NODE_FILLED 0xFF
-#define HASHMAP_NODE_DELETED 0x01
+// Control bytes : a filled slot stores the low 7 bits of its hash,
+// free and deleted slots have the high bit set.
+#define HASHMAP_CTRL_FREE 0x80
+#define HASHMAP_CTRL_DELETED 0xFE
+#define HASHMAP_CTRL_FILLED(ctrl) (((ctrl) & 0x80) == 0)
 
+// Number of control bytes scanned at once (one SSE2 register)
+#define HASHMAP_GROUP_WIDTH 16
+
+// Keys hashed and prefetched ahead of probing by hashmap_get_many
+#define HASHMAP_BATCH_SIZE 32
+
+// Capacities are powers of two so probing can mask instead of taking a modulo
 static const size_t HASHMAP_INITIAL_CAPACITY = 64;
 static const double HASHMAP_LOAD_FACTOR = 0.75;
+// Share of the capacity taken by tombstones at which growth rebuilds at the same capacity
+static const double HASHMAP_TOMBSTONE_RATIO = 0.25;
+// Groups an insertion may probe past before the watchdog reseeds the map
+static const size_t HASHMAP_PROBE_LIMIT = 8;
 
 /**
  * Type Structures
  */
 
+typedef enum { HASHMAP_PROBE_TRIANGULAR = 0,  // Group strides of 16, 32, 48, ... (default)
+               HASHMAP_PROBE_LINEAR = 1,      // Consecutive groups
+               HASHMAP_PROBE_ROBIN_HOOD = 2   // Consecutive slots, entries far from home evict closer ones
+} hashmap_probe;
+
+// Slot of a map holding pointers, a map without values stops before value.
+// Inline maps keep the same leading hash followed by the key and value bytes themselves.
 typedef struct HashMapNode {
+    size_t hash;  // Cached hash of key, reused on rehash and checked before the comparator
     void *key;
     void *value;
-    unsigned char status;
 } HashMapNode;
 
+// Slot of a dense map, entry is the position of the key and value in the entries array
+typedef struct HashMapIndex {
+    size_t hash;
+    size_t entry;
+} HashMapIndex;
+
 typedef struct HashMap {
-    HashMapNode *nodes;
+    unsigned char *nodes;  // capacity slots of slot_size bytes
+    unsigned char *ctrl;   // capacity + HASHMAP_GROUP_WIDTH bytes, the tail mirrors the first group
     size_t occupied_size;
     size_t size;
     size_t capacity;
     type_methods *key_methods;
     type_methods *value_methods;
+    hashmap_probe probe;
+
+    // Slot layout
+    size_t slot_size;
+    size_t key_size;         // Inline key bytes, 0 when keys and values are pointers
+    size_t value_size;       // Inline value bytes, sizeof(void *) for pointers and 0 when there are no values
+    size_t key_offset;
+    size_t value_offset;
+    unsigned char *scratch;  // Room for two slots while entries are moved around
+
+    // Dense layout : slots are HashMapIndex, the entries are kept in insertion order
+    bool dense;
+    unsigned char *entries;
+    bool *entry_live;       // Removed entries stay in place until the next compaction
+    size_t entry_count;     // Live and removed entries
+    size_t entry_capacity;
+    size_t entry_size;      // HashMapNode, or the hash, key and value of an inline map
+
+    // Incremental resize : the previous table while its entries move over
+    unsigned char *old_nodes;
+    unsigned char *old_ctrl;
+    size_t old_capacity;      // 0 when no migration is in progress
+    size_t old_size;          // Entries not moved yet, also counted in size
+    size_t migrate_index;     // Next slot of the previous table to move
+    size_t migration_budget;  // Least slots of the previous table moved per insert or remove, 0 resizes synchronously
+
+    double shrink_load_factor;  // Load below which removals shrink the table, 0 never shrinks
+
+    // Hash flooding protection
+    uint64_t seed;                     // Passed to the seeded hash of the keys, random unless set with hashmap_reseed
+    seeded_hash_function seeded_hash;  // Seeded hash of the key type, NULL when the seed is mixed into the key hash
+    bool watchdog;           // Reseed when an insertion probes past HASHMAP_PROBE_LIMIT groups
+    bool reseed_pending;     // Set by an insertion, acted on before the next key is hashed
+    size_t reseed_capacity;  // Capacity at the last reseed, the watchdog waits for the table to grow
+
+    // Negative lookups : keys absent from the filter are reported missing without probing
+    BloomFilter *filter;  // NULL unless attached, holds the cached hash of every key
 } HashMap;
 
 // ==== Method Overview ====
 
 // Private Methods :
 
-// size_t hashmap_probe_next(HashMap *map, size_t index, size_t probe_count);
+// uint32_t hashmap_group_match(const unsigned char *group, unsigned char h2);
+// uint32_t hashmap_group_match_free(const unsigned char *group);
+// uint32_t hashmap_group_match_free_or_deleted(const unsigned char *group);
+// void hashmap_set_ctrl(HashMap *map, size_t index, unsigned char ctrl);
+// void hashmap_store_ctrl(unsigned char *ctrl, size_t capacity, size_t index, unsigned char value);
+// size_t hashmap_probe_next(HashMap *map, size_t pos, size_t *stride, size_t mask);
+// size_t hashmap_displacement(HashMap *map, size_t index, size_t hash);
+// size_t hashmap_probe_length(HashMap *map, size_t index, size_t hash);
+// uint64_t hashmap_mix(uint64_t value);
+// uint64_t hashmap_secret_word(void);
+// uint64_t hashmap_random_seed(void);
+// void hashmap_watchdog(HashMap *map);
+// unsigned char *hashmap_node(HashMap *map, size_t index);
+// int hashmap_compare_keys(HashMap *map, void *first, void *second);
+// unsigned char *hashmap_find_in(HashMap *map, unsigned char *nodes, unsigned char *ctrl, size_t capacity, void *key, size_t hash);
+// unsigned char *hashmap_slot_entry(HashMap *map, unsigned char *slot);
+// unsigned char *hashmap_find(HashMap *map, void *key, size_t hash);
+// unsigned char *hashmap_find_entry(HashMap *map, void *key, size_t hash);
+// unsigned char *hashmap_find_or_insert(HashMap *map, void *key, size_t hash, bool *inserted, bool adopt_key);
+// bool hashmap_remove_entry(HashMap *map, void *key, size_t hash, void **out_key, void **out_value);
+// size_t hashmap_find_insert_index(HashMap *map, size_t hash);
+// size_t hashmap_robin_hood_insert_index(HashMap *map, size_t hash);
+// size_t hashmap_claim_index(HashMap *map, size_t hash);
+// size_t hashmap_insert_index(HashMap *map, size_t hash);
+// size_t hashmap_round_capacity(size_t capacity);
+// size_t hashmap_capacity_for(size_t size);
+// void hashmap_grow(HashMap *map);
+// void hashmap_migrate(HashMap *map, size_t budget);
+// size_t hashmap_migration_step(HashMap *map);
+// bool hashmap_was_never_full(HashMap *map, size_t index);
+// void hashmap_backward_shift(HashMap *map, size_t hole);
+// void hashmap_purge_tombstones(HashMap *map);
+// size_t hashmap_field_alignment(size_t size);
+// bool hashmap_dense_reserve(HashMap *map);
+// void hashmap_dense_rebuild(HashMap *map, size_t capacity);
+// bool hashmap_dense_resize_entries(HashMap *map, size_t entry_capacity);
+// void hashmap_shrink(HashMap *map, size_t capacity);
+// void hashmap_filter_rebuild(HashMap *map, double false_positive_rate);
+// HashMap *hashmap_create_layout(type_methods *key_methods, type_methods *value_methods, hashmap_probe probe, size_t key_size, size_t value_size, bool dense, size_t capacity);
 // bool hashmap_need_rehash(HashMap *map, size_t new_size);
 
 // Constructors and destructors :
 
 HashMap *hashmap_create(type_methods *key_methods, type_methods *value_methods);
+HashMap *hashmap_create_with_probe(type_methods *key_methods, type_methods *value_methods, hashmap_probe probe);
+HashMap *hashmap_create_with_capacity(type_methods *key_methods, type_methods *value_methods, size_t expected_size);
+HashMap *hashmap_create_inline(type_methods *key_methods, size_t key_size, size_t value_size);
+HashMap *hashmap_create_dense(type_methods *key_methods, type_methods *value_methods);
+HashMap *hashmap_create_inline_dense(type_methods *key_methods, size_t key_size, size_t value_size);
+HashMap *hashmap_create_keys(type_methods *key_methods);
 void hashmap_destroy(HashMap *this);
 
 // Access and iteration :
 
+size_t hashmap_hash(HashMap *map, void *key);
 void *hashmap_get(HashMap *map, void *key);
+void *hashmap_get_hashed(HashMap *map, void *key, size_t hash);
+size_t hashmap_get_many(HashMap *map, void **keys, size_t n, void **out_values);
 void *hashmap_get_key(HashMap *map, void *key);
 bool hashmap_contains(HashMap *map, void *key);
-
-// HashMapNode *hashmap_find(HashMap *map, void *key);
+bool hashmap_contains_hashed(HashMap *map, void *key, size_t hash);
+void *hashmap_entry(HashMap *map, void *key, bool *inserted);
+void *hashmap_entry_key(HashMap *map, void *entry);
+void *hashmap_entry_value(HashMap *map, void *entry);
+void hashmap_entry_set(HashMap *map, void *entry, void *value);
 
 // Capacity :
 
@@ -65,13 +182,29 @@ size_t hashmap_occupied_size(HashMap *map);
 size_t hashmap_capacity(HashMap *map);
 
 void hashmap_rehash(HashMap *map, size_t new_capacity);
+void hashmap_reserve(HashMap *map, size_t size);
+void hashmap_shrink_to_fit(HashMap *map);
+void hashmap_set_shrink_threshold(HashMap *map, double load_factor);
+void hashmap_set_migration_budget(HashMap *map, size_t budget);
+bool hashmap_migrating(HashMap *map);
+
+void hashmap_reseed(HashMap *map, uint64_t seed);
+void hashmap_set_watchdog(HashMap *map, bool enabled);
+
+void hashmap_attach_filter(HashMap *map, double false_positive_rate);
+void hashmap_detach_filter(HashMap *map);
 
 // Modifiers :
 
 void hashmap_add(HashMap *map, void *key);
 void hashmap_set(HashMap *map, void *key, void *value);
+void hashmap_set_hashed(HashMap *map, void *key, size_t hash, void *value);
+void hashmap_set_owned(HashMap *map, void *key, void *value);
 void hashmap_reset(HashMap *map, void *key);
 void hashmap_remove(HashMap *map, void *key);
+void hashmap_remove_hashed(HashMap *map, void *key, size_t hash);
+bool hashmap_take(HashMap *map, void *key, void **out_key, void **out_value);
+void hashmap_clear(HashMap *map);
 
 // Copy constructors and creators :
 
@@ -81,35 +214,54 @@ HashMap *hashmap_clone(HashMap *this, type_methods *new_data_methods);
 
 // ==== Macros ====
 
-#define HASHMAP_KEYS_FOREACH(map, varname, callback)           \
-    do {                                                       \
-        for (size_t _i = 0; _i < map->capacity; _i++) {        \
-            if (map->nodes[_i].status == HASHMAP_NODE_FILLED) { \
-                varname = map->nodes[_i].key;                   \
-                callback;                                      \
-            }                                                  \
-        }                                                      \
+// Slots of the table followed by the slots of a table still being migrated away from
+#define HASHMAP_SLOT_COUNT(map) ((map)->capacity + (map)->old_capacity)
+#define HASHMAP_SLOT_CTRL(map, i) ((i) < (map)->capacity ? (map)->ctrl[i] : (map)->old_ctrl[(i) - (map)->capacity])
+#define HASHMAP_SLOT_NODE(map, i) ((i) < (map)->capacity ? HASHMAP_NODE_AT(map, (map)->nodes, i) : HASHMAP_NODE_AT(map, (map)->old_nodes, (i) - (map)->capacity))
+
+// Inline maps hand out pointers into the entry, pointer maps the stored pointers
+#define HASHMAP_INLINE(map) ((map)->key_size != 0)
+#define HASHMAP_HAS_VALUES(map) ((map)->value_size != 0)
+#define HASHMAP_NODE_AT(map, nodes, i) ((nodes) + (i) * (map)->slot_size)
+#define HASHMAP_ENTRY_AT(map, i) ((map)->entries + (i) * (map)->entry_size)
+#define HASHMAP_NODE_HASH(node) (*(size_t *)(node))
+#define HASHMAP_NODE_KEY(map, node) (HASHMAP_INLINE(map) ? (void *)((node) + (map)->key_offset) : *(void **)((node) + (map)->key_offset))
+#define HASHMAP_NODE_VALUE(map, node) (HASHMAP_INLINE(map) ? (void *)((node) + (map)->value_offset) : HASHMAP_HAS_VALUES(map) ? *(void **)((node) + (map)->value_offset) : NULL)
+
+// Iteration walks the entries array of a dense map and the slots of the other maps
+#define HASHMAP_ITER_COUNT(map) ((map)->dense ? (map)->entry_count : HASHMAP_SLOT_COUNT(map))
+#define HASHMAP_ITER_LIVE(map, i) ((map)->dense ? (map)->entry_live[i] : HASHMAP_CTRL_FILLED(HASHMAP_SLOT_CTRL(map, i)))
+#define HASHMAP_ITER_NODE(map, i) ((map)->dense ? HASHMAP_ENTRY_AT(map, i) : HASHMAP_SLOT_NODE(map, i))
+
+#define HASHMAP_KEYS_FOREACH(map, varname, callback)                         \
+    do {                                                                     \
+        for (size_t _i = 0; _i < HASHMAP_ITER_COUNT(map); _i++) {            \
+            if (HASHMAP_ITER_LIVE(map, _i)) {                                \
+                varname = HASHMAP_NODE_KEY(map, HASHMAP_ITER_NODE(map, _i)); \
+                callback;                                                    \
+            }                                                                \
+        }                                                                    \
     } while (0)
 
-#define HASHMAP_VALUES_FOREACH(map, varname, callback)         \
-    do {                                                       \
-        for (size_t _i = 0; _i < map->capacity; _i++) {        \
-            if (map->nodes[_i].status == HASHMAP_NODE_FILLED) { \
-                varname = map->nodes[_i].value;                 \
-                callback;                                      \
-            }                                                  \
-        }                                                      \
+#define HASHMAP_VALUES_FOREACH(map, varname, callback)                         \
+    do {                                                                       \
+        for (size_t _i = 0; _i < HASHMAP_ITER_COUNT(map); _i++) {              \
+            if (HASHMAP_ITER_LIVE(map, _i)) {                                  \
+                varname = HASHMAP_NODE_VALUE(map, HASHMAP_ITER_NODE(map, _i)); \
+                callback;                                                      \
+            }                                                                  \
+        }                                                                      \
     } while (0)
 
-#define HASHMAP_PAIRS_FOREACH(map, keyname, valuename, callback) \
-    do {                                                         \
-        for (size_t _i = 0; _i < map->capacity; _i++) {          \
-            if (map->nodes[_i].status == HASHMAP_NODE_FILLED) {   \
-                keyname = map->nodes[_i].key;                     \
-                valuename = map->nodes[_i].value;                 \
-                callback;                                        \
-            }                                                    \
-        }                                                        \
+#define HASHMAP_PAIRS_FOREACH(map, keyname, valuename, callback)                 \
+    do {                                                                         \
+        for (size_t _i = 0; _i < HASHMAP_ITER_COUNT(map); _i++) {                \
+            if (HASHMAP_ITER_LIVE(map, _i)) {                                    \
+                keyname = HASHMAP_NODE_KEY(map, HASHMAP_ITER_NODE(map, _i));     \
+                valuename = HASHMAP_NODE_VALUE(map, HASHMAP_ITER_NODE(map, _i)); \
+                callback;                                                        \
+            }                                                                    \
+        }                                                                        \
     } while (0)
 
 #define HASHMAP_PRINTF(map, keyname, valuename, ...)     \
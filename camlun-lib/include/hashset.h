@@ -0,0 +1,71 @@
+#ifndef HASHSET_H
+#define HASHSET_H
+
+#include <stdbool.h>
+#include <stddef.h>
+
+#include "hashmap.h"
+#include "typemethods.h"
+
+/**
+ * Type Structures
+ */
+
+// A HashMap whose slots hold only the cached hash and the key
+typedef struct HashSet {
+    HashMap *map;
+    type_methods *data_methods;
+} HashSet;
+
+// ==== Method Overview ====
+
+// Constructors and destructors :
+
+HashSet *hashset_create(type_methods *data_methods);
+void hashset_destroy(HashSet *set);
+
+// Access and iteration :
+
+bool hashset_contains(HashSet *set, void *data);
+void *hashset_get_key(HashSet *set, void *data);
+
+// Capacity :
+
+bool hashset_empty(HashSet *set);
+size_t hashset_size(HashSet *set);
+void hashset_reserve(HashSet *set, size_t size);
+
+// Modifiers :
+
+void hashset_add(HashSet *set, void *data);
+void hashset_remove(HashSet *set, void *data);
+void hashset_clear(HashSet *set);
+
+// Copy constructors and creators :
+
+HashSet *hashset_clone(HashSet *set);
+HashSet *hashset_union(HashSet *first, HashSet *second);
+HashSet *hashset_intersection(HashSet *first, HashSet *second);
+HashSet *hashset_difference(HashSet *first, HashSet *second);
+
+// ==== End of Method Overview ====
+
+// ==== Macros ====
+
+#define HASHSET_FOREACH(set, varname, callback) HASHMAP_KEYS_FOREACH((set)->map, varname, callback)
+
+#define HASHSET_PRINTF(set, varname, ...)       \
+    do {                                        \
+        printf("{");                            \
+        size_t _counter = 0;                    \
+        HASHSET_FOREACH(set, varname, {         \
+            _counter++;                         \
+            printf(__VA_ARGS__);                \
+            if (_counter < hashset_size(set)) { \
+                printf(", ");                   \
+            }                                   \
+        });                                     \
+        printf("}");                            \
+    } while (0)
+
+#endif
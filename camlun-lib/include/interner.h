@@ -0,0 +1,54 @@
+#ifndef INTERNER_H
+#define INTERNER_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "hashmap.h"
+#include "typemethods.h"
+#include "vector.h"
+
+/**
+ * Type Structures
+ */
+
+// Hands out one canonical copy per distinct string, along with a dense symbol numbering
+// the strings in the order they were first interned. Canonical strings live until the
+// interner is destroyed and must not be modified.
+typedef struct Interner {
+    HashMap *symbols;  // <TYPE_STRING, uint32_t>, the keys are the canonical strings
+    Vector *strings;   // Canonical strings indexed by symbol, not owned
+} Interner;
+
+// ==== Method Overview ====
+
+// Constructors and destructors :
+
+Interner *interner_create();
+void interner_destroy(Interner *interner);
+
+// Access :
+
+char *interner_find(Interner *interner, const char *str);
+char *interner_string(Interner *interner, uint32_t symbol);
+size_t interner_size(Interner *interner);
+
+// Modifiers :
+
+char *interner_intern(Interner *interner, const char *str);
+uint32_t interner_symbol(Interner *interner, const char *str);
+
+// Type methods for canonical strings, use with TYPE_INIT(..., interned) or TYPE_INIT_SEEDED(..., interned).
+// Keys are hashed and compared as pointers and never copied nor freed, the interner owns them.
+
+void *interned_default_constructor();
+void interned_destructor(void *ptr);
+void *interned_copy_constructor(void *ptr);
+int interned_comparator(void *first, void *second);
+size_t interned_hash_function(void *ptr);
+size_t interned_seeded_hash_function(void *ptr, uint64_t seed);
+
+// ==== End of Method Overview ====
+
+#endif
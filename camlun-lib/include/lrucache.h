@@ -0,0 +1,99 @@
+#ifndef LRUCACHE_H
+#define LRUCACHE_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "hashmap.h"
+#include "typemethods.h"
+
+/**
+ * Type Structures
+ */
+
+#define LRUCACHE_NONE UINT32_MAX
+
+typedef enum lrucache_policy {
+    LRUCACHE_LRU,    // Evicts the least recently used entry, every hit relinks the entry
+    LRUCACHE_CLOCK,  // Second chance : a hit only sets a bit, the hand sweeps past referenced entries once
+} lrucache_policy;
+
+// Called with the key and value of an entry evicted to make room, before they are destroyed
+typedef void (*lrucache_evict_callback)(void *key, void *value, void *context);
+
+// One entry, the recency links are indices into the node array of the cache
+typedef struct LruCacheNode {
+    void *key;    // Same pointer as the key in the map
+    void *value;  // Owned by the cache
+    uint32_t prev;
+    uint32_t next;  // Next in the recency list, or in the free list while unused
+    bool used;
+    bool referenced;
+} LruCacheNode;
+
+// A bounded map evicting on insertion once full. Nodes are allocated once with the cache
+// and the map is sized for the capacity upfront, so hits never allocate.
+typedef struct LruCache {
+    HashMap *map;  // <key, LruCacheNode *>
+    type_methods *key_methods;
+    type_methods *value_methods;
+
+    LruCacheNode *nodes;
+    size_t capacity;
+    size_t size;
+    lrucache_policy policy;
+
+    uint32_t head;  // Most recently used (LRU)
+    uint32_t tail;  // Least recently used (LRU)
+    uint32_t hand;  // Next node the clock looks at (CLOCK)
+    uint32_t free;  // First unused node
+
+    lrucache_evict_callback on_evict;
+    void *evict_context;
+
+    size_t hits;
+    size_t misses;
+    size_t evictions;
+} LruCache;
+
+// ==== Method Overview ====
+
+// Private Methods :
+
+// void lrucache_unlink(LruCache *cache, uint32_t index);
+// void lrucache_push_front(LruCache *cache, uint32_t index);
+// uint32_t lrucache_victim(LruCache *cache);
+// void lrucache_release(LruCache *cache, uint32_t index, bool evicted);
+
+// Constructors and destructors :
+
+LruCache *lrucache_create(type_methods *key_methods, type_methods *value_methods, size_t capacity);
+LruCache *lrucache_create_clock(type_methods *key_methods, type_methods *value_methods, size_t capacity);
+void lrucache_destroy(LruCache *cache);
+
+// Access :
+
+void *lrucache_get(LruCache *cache, void *key);
+void *lrucache_peek(LruCache *cache, void *key);
+bool lrucache_contains(LruCache *cache, void *key);
+
+// Capacity and statistics :
+
+size_t lrucache_size(LruCache *cache);
+size_t lrucache_capacity(LruCache *cache);
+size_t lrucache_hits(LruCache *cache);
+size_t lrucache_misses(LruCache *cache);
+size_t lrucache_evictions(LruCache *cache);
+void lrucache_reset_stats(LruCache *cache);
+
+// Modifiers :
+
+void lrucache_put(LruCache *cache, void *key, void *value);
+void lrucache_remove(LruCache *cache, void *key);
+void lrucache_clear(LruCache *cache);
+void lrucache_set_evict_callback(LruCache *cache, lrucache_evict_callback callback, void *context);
+
+// ==== End of Method Overview ====
+
+#endif
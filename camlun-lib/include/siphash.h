@@ -0,0 +1,11 @@
+#ifndef SIPHASH_H
+#define SIPHASH_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+// SipHash-1-3 : a keyed hash, so that without the 128 bit key an adversary cannot
+// build inputs that collide. One compression round and three finalization rounds.
+uint64_t siphash13(const void *data, size_t len, uint64_t k0, uint64_t k1);
+
+#endif
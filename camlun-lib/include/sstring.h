@@ -0,0 +1,55 @@
+#ifndef SSTRING_H
+#define SSTRING_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "typemethods.h"
+
+/**
+ * Type Structures
+ */
+
+#define SSTRING_INLINE_CAPACITY 23
+
+// A string that carries its length and hash, with the characters stored in place up to
+// SSTRING_INLINE_CAPACITY bytes and on the heap beyond. Always nul terminated.
+typedef struct SString {
+    size_t hash;    // numerical_hash_function of the characters, computed once on creation
+    size_t length;  // Characters, without the nul
+    union {
+        char inline_data[SSTRING_INLINE_CAPACITY + 1];
+        char *heap_data;
+    };
+} SString;
+
+// ==== Method Overview ====
+
+// Constructors and destructors :
+
+SString *sstring_create(const char *str);
+SString *sstring_create_length(const char *str, size_t length);
+SString sstring_borrow(const char *str);  // Lookup key on the stack, never destroyed, points at str past the inline capacity
+
+// Access :
+
+const char *sstring_data(const SString *sstring);
+size_t sstring_length(const SString *sstring);
+bool sstring_equals(const SString *first, const SString *second);
+
+// Type methods, use with TYPE_INIT(..., sstring) or TYPE_INIT_SEEDED(..., sstring).
+// sstring_comparator orders by length, then hash, then characters, so that unequal strings
+// are told apart without reading them. Sorted containers wanting strcmp order take sstring_lexical_comparator.
+
+void *sstring_default_constructor();
+void sstring_destructor(void *ptr);
+void *sstring_copy_constructor(void *ptr);
+int sstring_comparator(void *first, void *second);
+int sstring_lexical_comparator(void *first, void *second);
+size_t sstring_hash_function(void *ptr);
+size_t sstring_seeded_hash_function(void *ptr, uint64_t seed);
+
+// ==== End of Method Overview ====
+
+#endif
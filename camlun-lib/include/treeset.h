@@ -6,6 +6,7 @@
 #include <stdbool.h>
 #include <stddef.h>
 
+#include "bloomfilter.h"
 #include "typemethods.h"
 
 // ==== End of Includes ====
@@ -37,6 +38,7 @@ typedef struct TreeSet {
     TreeSetNode *root;
     size_t size;
     type_methods *data_methods;
+    BloomFilter *filter;  // NULL unless attached, turns away absent data before walking the tree
 } TreeSet;
 
 // ==== End of Type Definitions ====
@@ -54,16 +56,19 @@ typedef struct TreeSet {
 // TreeSetNode *treesetnode_double_rotate(TreeSetNode *node, direction dir);
 // bool treesetnode_red(TreeSetNode *node);
 // void treesetnode_color_flip(TreeSetNode *node);
-// TreeSetNode *treeset_delete_helper(TreeSet *set, TreeSetNode *node, void *data, bool *balanced);
+// TreeSetNode *treeset_delete_helper(TreeSet *set, TreeSetNode *node, void *data, bool *balanced, void **removed);
 // TreeSetNode *treeset_insert_helper(TreeSet *set, TreeSetNode *node, void *data);
 // void treeset_destroy_helper(TreeSet *set, TreeSetNode *node);
 // void treeset_insert(TreeSet *set, void *data);
-// void treeset_delete(TreeSet *set, void *data);
+// void *treeset_delete(TreeSet *set, void *data);
+// void treeset_filter_rebuild(TreeSet *set, double false_positive_rate);
 
 // Constructors and destructors :
 
 TreeSet *treeset_create(type_methods *data_methods);
 void treeset_destroy(TreeSet *this);
+void treeset_attach_filter(TreeSet *this, double false_positive_rate);
+void treeset_detach_filter(TreeSet *this);
 
 // Access and iteration :
 
@@ -84,6 +89,9 @@ size_t treeset_size(TreeSet *this);
 
 void treeset_add(TreeSet *this, void *data);
 void treeset_remove(TreeSet *this, void *data);
+
+void treeset_add_owned(TreeSet *this, void *data);
+void *treeset_take(TreeSet *this, void *data);
 void treeset_clear(TreeSet *this);
 
 // Copy constructors or creators :
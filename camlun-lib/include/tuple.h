@@ -23,7 +23,7 @@
     }                                                                 \
                                                                       \
     static size_t struct_name##_hash_function(void *ptr) {            \
-        return numerical_hash_function(sizeof(struct_name), ptr);     \
+        return numerical_hash_inline(sizeof(struct_name), ptr);       \
     }                                                                 \
                                                                       \
     static int struct_name##_comparator(void *first, void *second) {  \
@@ -6,6 +6,8 @@
 #include <stdlib.h>
 #include <string.h>
 
+#include "hashkernel.h"
+
 /**
  * @brief Default constructor function pointer type.
  */
@@ -33,6 +35,11 @@ typedef int (*comparator)(void *, void *);
  */
 typedef size_t (*hash_function)(void *);
 
+/**
+ * Hash function pointer type keyed by the seed of the container holding the data.
+ */
+typedef size_t (*seeded_hash_function)(void *, uint64_t);
+
 static const uint32_t HASH_SEED = 0x12345678;
 
 /**
@@ -45,9 +52,19 @@ typedef struct {
     copy_constructor dup;
     comparator cmp;
     hash_function hash;
+    seeded_hash_function seeded_hash;  // Optional, preferred by containers that have their own seed
 } type_methods;
 
 size_t numerical_hash_function(size_t type_size, void *ptr);
+size_t numerical_seeded_hash_function(size_t type_size, void *ptr, uint64_t seed);
+
+// Inlined where type_size is a constant, so that small types hash with the kernel of their width
+static inline size_t numerical_hash_inline(size_t type_size, void *ptr) {
+    if (type_size <= HASH_KERNEL_MAX_SIZE) {
+        return (size_t)hash_kernel(ptr, type_size, HASH_SEED);
+    }
+    return numerical_hash_function(type_size, ptr);
+}
 
 /**
  * Constructors
@@ -244,6 +261,51 @@ size_t ptrdiff_t_hash_function(void *ptr);
 size_t string_hash_function(void *ptr);
 size_t shallow_hash_function(void *ptr);
 
+/**
+ * Seeded Hash Functions
+ */
+
+size_t bool_seeded_hash_function(void *ptr, uint64_t seed);
+size_t char_seeded_hash_function(void *ptr, uint64_t seed);
+size_t signed_char_seeded_hash_function(void *ptr, uint64_t seed);
+size_t unsigned_char_seeded_hash_function(void *ptr, uint64_t seed);
+size_t short_seeded_hash_function(void *ptr, uint64_t seed);
+size_t unsigned_short_seeded_hash_function(void *ptr, uint64_t seed);
+size_t int_seeded_hash_function(void *ptr, uint64_t seed);
+size_t unsigned_int_seeded_hash_function(void *ptr, uint64_t seed);
+size_t long_seeded_hash_function(void *ptr, uint64_t seed);
+size_t unsigned_long_seeded_hash_function(void *ptr, uint64_t seed);
+size_t long_long_seeded_hash_function(void *ptr, uint64_t seed);
+size_t unsigned_long_long_seeded_hash_function(void *ptr, uint64_t seed);
+size_t float_seeded_hash_function(void *ptr, uint64_t seed);
+size_t double_seeded_hash_function(void *ptr, uint64_t seed);
+size_t long_double_seeded_hash_function(void *ptr, uint64_t seed);
+
+size_t int8_t_seeded_hash_function(void *ptr, uint64_t seed);
+size_t int16_t_seeded_hash_function(void *ptr, uint64_t seed);
+size_t int32_t_seeded_hash_function(void *ptr, uint64_t seed);
+size_t int64_t_seeded_hash_function(void *ptr, uint64_t seed);
+size_t intmax_t_seeded_hash_function(void *ptr, uint64_t seed);
+size_t intptr_t_seeded_hash_function(void *ptr, uint64_t seed);
+size_t uint8_t_seeded_hash_function(void *ptr, uint64_t seed);
+size_t uint16_t_seeded_hash_function(void *ptr, uint64_t seed);
+size_t uint32_t_seeded_hash_function(void *ptr, uint64_t seed);
+size_t uint64_t_seeded_hash_function(void *ptr, uint64_t seed);
+size_t uintmax_t_seeded_hash_function(void *ptr, uint64_t seed);
+size_t uintptr_t_seeded_hash_function(void *ptr, uint64_t seed);
+
+size_t size_t_seeded_hash_function(void *ptr, uint64_t seed);
+size_t ptrdiff_t_seeded_hash_function(void *ptr, uint64_t seed);
+
+size_t string_seeded_hash_function(void *ptr, uint64_t seed);
+size_t shallow_seeded_hash_function(void *ptr, uint64_t seed);
+
+/**
+ * @brief Seeded hash function of the built-in type hashed by hash, NULL for other hash functions.
+ * Lets containers seed keys described with plain TYPE_INIT or TYPE_METHODS.
+ */
+seeded_hash_function builtin_seeded_hash_function(hash_function hash);
+
 /**
  * @brief Macro to initialize a type_methods structure for a given type.
  */
@@ -265,6 +327,30 @@ size_t shallow_hash_function(void *ptr);
         .hash = type##_hash_function       \
     }
 
+/**
+ * @brief Same as TYPE_INIT and TYPE_METHODS with the seeded hash function of the type. Hash maps
+ * find the seeded hash of built-in types on their own, user types need these to be seeded.
+ */
+#define TYPE_INIT_SEEDED(varname, type)                  \
+    varname = (type_methods) {                           \
+        .crt = type##_default_constructor,               \
+        .del = type##_destructor,                        \
+        .dup = type##_copy_constructor,                  \
+        .cmp = type##_comparator,                        \
+        .hash = type##_hash_function,                    \
+        .seeded_hash = type##_seeded_hash_function       \
+    }
+
+#define TYPE_METHODS_SEEDED(type)                        \
+    (type_methods) {                                     \
+        .crt = type##_default_constructor,               \
+        .del = type##_destructor,                        \
+        .dup = type##_copy_constructor,                  \
+        .cmp = type##_comparator,                        \
+        .hash = type##_hash_function,                    \
+        .seeded_hash = type##_seeded_hash_function       \
+    }
+
 #define TYPE_INIT_CMP_OVERRIDE(varname, base_type, custom_id, comparison_code)     \
     static int _##base_type##_##custom_id##_comparator(void *first, void *second){ \
         comparison_code}                                                           \
@@ -349,7 +435,7 @@ size_t shallow_hash_function(void *ptr);
         do {                                               \
             code;                                          \
         } while (0);                                       \
-        return numerical_hash_function(sizeof(type), ptr); \
+        return numerical_hash_inline(sizeof(type), ptr);   \
     }
 
 #define NUMERICAL_COMPARE(type, first, second) \
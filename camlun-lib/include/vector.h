@@ -22,11 +22,15 @@
 
 typedef void *VectorNode;
 
+// Selects elements for vector_erase_if, data is the element as vector_get returns it
+typedef bool (*vector_predicate)(void *data, void *context);
+
 typedef struct {
-    VectorNode *nodes;           // Array of nodes
+    VectorNode *nodes;           // Array of nodes, or of the elements themselves for a sized vector
     size_t size;                 // Current number of elements
     size_t capacity;             // Current capacity of the vector
     type_methods *data_methods;  // Methods for managing the data type
+    size_t element_size;         // Bytes of each element stored in place, 0 when nodes holds pointers
 } Vector;
 
 // ==== End of Type Definitions ====
@@ -41,6 +45,7 @@ void vector_node_init(Vector *vector, VectorNode *node, void *data);
 // Constructors and destructors :
 
 Vector *vector_create(type_methods *data_methods);
+Vector *vector_create_sized(size_t element_size, type_methods *data_methods);
 void vector_destroy(Vector *this);
 
 // Access and iteration :
@@ -49,6 +54,7 @@ void *vector_get(Vector *this, size_t pos);
 void *vector_first(Vector *this);
 void *vector_last(Vector *this);
 
+// Node iterators and the node modifiers below are for pointer vectors only
 VectorNode *vector_at(Vector *this, size_t pos);
 VectorNode *vector_begin(Vector *this);
 VectorNode *vector_end(Vector *this);
@@ -72,10 +78,24 @@ void vector_erase(Vector *this, size_t pos);
 void vector_push_back(Vector *this, void *data);
 void vector_pop_back(Vector *this);
 
+// -- Ownership transfer, pointer vectors only
+
+void vector_set_owned(Vector *this, size_t pos, void *data);
+void vector_insert_owned(Vector *this, size_t pos, void *data);
+void vector_push_back_owned(Vector *this, void *data);
+void *vector_take(Vector *this, size_t pos);
+
 VectorNode *vector_insert_at(Vector *this, VectorNode *node, void *data);
 VectorNode *vector_erase_at(Vector *this, VectorNode *node);
 void vector_replace(Vector *this, VectorNode *node, void *data);
 
+// -- Ranges
+
+void vector_insert_range(Vector *this, size_t pos, void *data, size_t count);
+void vector_erase_range(Vector *this, size_t pos, size_t count);
+void vector_append(Vector *this, Vector *other);
+size_t vector_erase_if(Vector *this, vector_predicate predicate, void *context);
+
 void vector_truncate(Vector *this, size_t new_size);
 void vector_expand(Vector *this, size_t new_size);
 void vector_resize(Vector *this, size_t new_size);
@@ -92,58 +112,57 @@ Vector vector_slice(Vector *this, size_t offset, size_t count);
 
 // ==== Macros ====
 
-#define VECTOR_FPRINTF(stream, vector, varname, ...)   \
-    do {                                               \
-        fprintf(stream, "[");                          \
-        if (vector_size(vector) > 0) {                 \
-            VectorNode *node = vector_begin(vector);   \
-            while (1) {                                \
-                varname = *_node;                      \
-                fprintf(stream, __VA_ARGS__);          \
-                if (_node == vector_end(vector) - 1) { \
-                    break;                             \
-                }                                      \
-                _node++;                               \
-                fprintf(stream, ", ");                 \
-            }                                          \
-        }                                              \
-        printf("]");                                 \
+// Sized vectors keep their elements in place, element pos then sits element_size bytes apart
+#define VECTOR_SIZED(vector) ((vector)->element_size != 0)
+#define VECTOR_STRIDE(vector) (VECTOR_SIZED(vector) ? (vector)->element_size : sizeof(VectorNode))
+#define VECTOR_ELEMENT(vector, pos) ((void *)((unsigned char *)(vector)->nodes + (pos) * (vector)->element_size))
+
+// varname is the stored pointer of a boxed vector and a pointer to the element of a sized one, as vector_get
+#define VECTOR_FOREACH(vector, varname, callback)                \
+    do {                                                         \
+        for (size_t _i = 0; _i < vector_size(vector); _i++) {    \
+            varname = vector_get(vector, _i);                    \
+            callback;                                            \
+        }                                                        \
+    } while (0)
+
+#define VECTOR_FPRINTF(stream, vector, varname, ...)             \
+    do {                                                         \
+        fprintf(stream, "[");                                    \
+        for (size_t _i = 0; _i < vector_size(vector); _i++) {    \
+            varname = vector_get(vector, _i);                    \
+            fprintf(stream, __VA_ARGS__);                        \
+            if (_i + 1 < vector_size(vector)) {                  \
+                fprintf(stream, ", ");                           \
+            }                                                    \
+        }                                                        \
+        fprintf(stream, "]");                                    \
     } while (0)
 
-#define VECTOR_SPRINTF(buffer, vector, varname, ...)           \
-    do {                                                       \
-        sprintf(buffer, "[");                                  \
-        if (vector_size(vector) > 0) {                         \
-            VectorNode *_node = vector_begin(vector);          \
-            while (1) {                                        \
-                varname = *_node;                              \
-                sprintf(buffer + strlen(buffer), __VA_ARGS__); \
-                if (_node == vector_end(vector) - 1) {         \
-                    break;                                     \
-                }                                              \
-                _node++;                                       \
-                sprintf(buffer + strlen(buffer), ", ");        \
-            }                                                  \
-        }                                                      \
-        sprintf(buffer + strlen(buffer), "]\n");               \
+#define VECTOR_SPRINTF(buffer, vector, varname, ...)             \
+    do {                                                         \
+        sprintf(buffer, "[");                                    \
+        for (size_t _i = 0; _i < vector_size(vector); _i++) {    \
+            varname = vector_get(vector, _i);                    \
+            sprintf(buffer + strlen(buffer), __VA_ARGS__);       \
+            if (_i + 1 < vector_size(vector)) {                  \
+                sprintf(buffer + strlen(buffer), ", ");          \
+            }                                                    \
+        }                                                        \
+        sprintf(buffer + strlen(buffer), "]\n");                 \
     } while (0)
 
-#define VECTOR_PRINTF(vector, varname, ...)            \
-    do {                                               \
-        printf("[");                                   \
-        if (vector_size(vector) > 0) {                 \
-            VectorNode *_node = vector_begin(vector);  \
-            while (1) {                                \
-                varname = *_node;                      \
-                printf(__VA_ARGS__);                   \
-                if (_node == vector_end(vector) - 1) { \
-                    break;                             \
-                }                                      \
-                _node++;                               \
-                printf(", ");                          \
-            }                                          \
-        }                                              \
-        printf("]");                                 \
+#define VECTOR_PRINTF(vector, varname, ...)                      \
+    do {                                                         \
+        printf("[");                                             \
+        for (size_t _i = 0; _i < vector_size(vector); _i++) {    \
+            varname = vector_get(vector, _i);                    \
+            printf(__VA_ARGS__);                                 \
+            if (_i + 1 < vector_size(vector)) {                  \
+                printf(", ");                                    \
+            }                                                    \
+        }                                                        \
+        printf("]");                                             \
     } while (0)
 
 // === End of Macros ====
@@ -3,8 +3,30 @@
 
 #include <stdlib.h>
 #include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
 #include "vector.h"
 
+// Maps an element to an unsigned key, elements are ordered by their keys
+typedef uint64_t (*radix_key_function)(void *element);
+
+// Keys for radix_key_function whose unsigned order is the order of the values
+static inline uint64_t radix_key_unsigned(uint64_t value) {
+    return value;
+}
+
+static inline uint64_t radix_key_signed(int64_t value) {
+    return (uint64_t)value ^ (UINT64_C(1) << 63);
+}
+
+// -0.0 and 0.0 share a key, as they compare equal
+static inline uint64_t radix_key_double(double value) {
+    value = value == 0 ? 0 : value;
+    uint64_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+    return (bits >> 63) ? ~bits : bits | (UINT64_C(1) << 63);
+}
+
 // ==== Methods Overview ====
 
 // Access and iteration :
@@ -18,13 +40,19 @@
 void vector_heapify(Vector *this, size_t pos, bool is_max);
 void vector_build_heap(Vector *this, bool is_max);
 void *heap_poll(Vector *this, bool is_max);
+bool heap_poll_into(Vector *this, void *out, bool is_max);
 void heap_offer(Vector *this, void *data, bool is_max);
+void heap_offer_owned(Vector *this, void *data, bool is_max);
 void heap_update(Vector *this, size_t pos, void *data, bool is_max);
 
 // -- Sorting
 
 void vector_qsort(Vector *this, bool descending);
 void vector_sort(Vector *this, bool descending);
+void vector_stable_sort(Vector *this, bool descending);
+void vector_radix_sort(Vector *this, bool descending);
+void vector_radix_sort_by(Vector *this, radix_key_function key, bool descending);
+void vector_sort_parallel(Vector *this, bool descending, size_t thread_count);
 
 
 // Copy constructors or creators : 
@@ -0,0 +1,180 @@
+#include "bloomfilter.h"
+
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+// ==== Method Overview ====
+
+// Private Methods :
+
+static uint64_t *bloomfilter_block(BloomFilter *filter, size_t hash);
+static size_t bloomfilter_next_bit(uint64_t *bits, size_t i);
+
+// Constructors and destructors :
+
+BloomFilter *bloomfilter_create(type_methods *data_methods, size_t expected_size, double false_positive_rate);
+BloomFilter *bloomfilter_clone(BloomFilter *filter);
+void bloomfilter_destroy(BloomFilter *filter);
+
+// Access :
+
+bool bloomfilter_contains(BloomFilter *filter, void *data);
+bool bloomfilter_contains_hash(BloomFilter *filter, size_t hash);
+
+// Capacity and tuning :
+
+size_t bloomfilter_size(BloomFilter *filter);
+size_t bloomfilter_capacity(BloomFilter *filter);
+size_t bloomfilter_bit_count(BloomFilter *filter);
+size_t bloomfilter_hash_count(BloomFilter *filter);
+double bloomfilter_estimated_false_positive_rate(BloomFilter *filter);
+
+// Modifiers :
+
+void bloomfilter_add(BloomFilter *filter, void *data);
+void bloomfilter_add_hash(BloomFilter *filter, size_t hash);
+void bloomfilter_clear(BloomFilter *filter);
+
+// ==== End of Method Overview ====
+
+// Multiplier of Fibonacci hashing, odd so that it is a bijection
+static const uint64_t BLOOMFILTER_MIX = 0x9E3779B97F4A7C15ULL;
+static const double BLOOMFILTER_LN2 = 0.69314718055994530942;
+
+// Private methods
+
+// The high half of the hash picks the block, the bit positions come from the mixed whole
+static uint64_t *bloomfilter_block(BloomFilter *filter, size_t hash) {
+    uint64_t high = (uint64_t)hash >> 32;
+    return filter->blocks + ((high * filter->block_count) >> 32) * BLOOMFILTER_BLOCK_WORDS;
+}
+
+// Position of bit i within the block, 9 bits at a time from the top of bits, remixed every 7 positions
+static size_t bloomfilter_next_bit(uint64_t *bits, size_t i) {
+    if (i != 0 && i % 7 == 0) {
+        *bits = (*bits ^ (*bits >> 29)) * BLOOMFILTER_MIX;
+    }
+    size_t position = (size_t)(*bits >> 55);
+    *bits = (*bits << 9) | (*bits >> 55);
+    return position;
+}
+
+// Constructors and destructors
+
+// Sized for expected_size elements at the given false positive rate. The hash count is the optimum
+// of a classic filter, the bit budget gets a tenth more since blocking concentrates the bits.
+BloomFilter *bloomfilter_create(type_methods *data_methods, size_t expected_size, double false_positive_rate) {
+    if (false_positive_rate <= 0 || false_positive_rate >= 1) {
+        return NULL;
+    }
+    BloomFilter *filter = malloc(sizeof(BloomFilter));
+    if (filter == NULL) {
+        return NULL;
+    }
+    double bits_per_element = -log(false_positive_rate) / (BLOOMFILTER_LN2 * BLOOMFILTER_LN2);
+    size_t hash_count = (size_t)lround(bits_per_element * BLOOMFILTER_LN2);
+    hash_count = hash_count < 1 ? 1 : hash_count > BLOOMFILTER_MAX_HASHES ? BLOOMFILTER_MAX_HASHES : hash_count;
+    double bits = ceil(bits_per_element * 1.1 * (expected_size > 0 ? expected_size : 1));
+    size_t block_count = (size_t)ceil(bits / BLOOMFILTER_BLOCK_BITS);
+
+    filter->block_count = block_count > 0 ? block_count : 1;
+    filter->blocks = aligned_alloc(BLOOMFILTER_BLOCK_BITS / 8, filter->block_count * BLOOMFILTER_BLOCK_BITS / 8);
+    if (filter->blocks == NULL) {
+        free(filter);
+        return NULL;
+    }
+    filter->hash_count = hash_count;
+    filter->capacity = expected_size;
+    filter->false_positive_rate = false_positive_rate;
+    filter->data_methods = data_methods;
+    bloomfilter_clear(filter);
+    return filter;
+}
+
+BloomFilter *bloomfilter_clone(BloomFilter *filter) {
+    BloomFilter *clone = malloc(sizeof(BloomFilter));
+    if (clone == NULL) {
+        return NULL;
+    }
+    memcpy(clone, filter, sizeof(BloomFilter));
+    clone->blocks = aligned_alloc(BLOOMFILTER_BLOCK_BITS / 8, filter->block_count * BLOOMFILTER_BLOCK_BITS / 8);
+    if (clone->blocks == NULL) {
+        free(clone);
+        return NULL;
+    }
+    memcpy(clone->blocks, filter->blocks, filter->block_count * BLOOMFILTER_BLOCK_BITS / 8);
+    return clone;
+}
+
+void bloomfilter_destroy(BloomFilter *filter) {
+    if (filter == NULL) {
+        return;
+    }
+    free(filter->blocks);
+    free(filter);
+}
+
+// Access
+
+bool bloomfilter_contains(BloomFilter *filter, void *data) {
+    return bloomfilter_contains_hash(filter, USE_HASH(filter->data_methods, data));
+}
+
+bool bloomfilter_contains_hash(BloomFilter *filter, size_t hash) {
+    uint64_t *block = bloomfilter_block(filter, hash);
+    uint64_t bits = (uint64_t)hash * BLOOMFILTER_MIX;
+    for (size_t i = 0; i < filter->hash_count; i++) {
+        size_t position = bloomfilter_next_bit(&bits, i);
+        if (!(block[position / 64] & ((uint64_t)1 << (position % 64)))) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Capacity and tuning
+
+size_t bloomfilter_size(BloomFilter *filter) {
+    return filter->size;
+}
+
+size_t bloomfilter_capacity(BloomFilter *filter) {
+    return filter->capacity;
+}
+
+size_t bloomfilter_bit_count(BloomFilter *filter) {
+    return filter->block_count * BLOOMFILTER_BLOCK_BITS;
+}
+
+size_t bloomfilter_hash_count(BloomFilter *filter) {
+    return filter->hash_count;
+}
+
+// Rate of a classic filter of the same size holding size elements, blocking adds a little on top
+double bloomfilter_estimated_false_positive_rate(BloomFilter *filter) {
+    double k = (double)filter->hash_count;
+    double fill = 1.0 - exp(-k * filter->size / bloomfilter_bit_count(filter));
+    return pow(fill, k);
+}
+
+// Modifiers
+
+void bloomfilter_add(BloomFilter *filter, void *data) {
+    bloomfilter_add_hash(filter, USE_HASH(filter->data_methods, data));
+}
+
+void bloomfilter_add_hash(BloomFilter *filter, size_t hash) {
+    uint64_t *block = bloomfilter_block(filter, hash);
+    uint64_t bits = (uint64_t)hash * BLOOMFILTER_MIX;
+    for (size_t i = 0; i < filter->hash_count; i++) {
+        size_t position = bloomfilter_next_bit(&bits, i);
+        block[position / 64] |= (uint64_t)1 << (position % 64);
+    }
+    filter->size++;
+}
+
+void bloomfilter_clear(BloomFilter *filter) {
+    memset(filter->blocks, 0, filter->block_count * BLOOMFILTER_BLOCK_BITS / 8);
+    filter->size = 0;
+}
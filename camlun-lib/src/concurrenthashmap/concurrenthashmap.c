@@ -0,0 +1,187 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include "concurrenthashmap.h"
+
+#include <pthread.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+#include "hashmap.h"
+
+// Each shard sits on its own cache lines so that locking one does not slow down its neighbours
+#define CONCURRENTHASHMAP_SHARD_ALIGNMENT 64
+
+struct ConcurrentHashMapShard {
+    _Alignas(CONCURRENTHASHMAP_SHARD_ALIGNMENT) pthread_rwlock_t lock;
+    HashMap *map;
+};
+
+// ==== Method Overview ====
+
+// Private Methods :
+
+static size_t concurrenthashmap_shard_of(ConcurrentHashMap *map, size_t hash);
+
+// Constructors and destructors :
+
+ConcurrentHashMap *concurrenthashmap_create(type_methods *key_methods, type_methods *value_methods, size_t shard_count);
+void concurrenthashmap_destroy(ConcurrentHashMap *map);
+
+// Access and iteration :
+
+void *concurrenthashmap_get(ConcurrentHashMap *map, void *key);
+bool concurrenthashmap_contains(ConcurrentHashMap *map, void *key);
+
+HashMap *concurrenthashmap_read_lock(ConcurrentHashMap *map, size_t shard);
+void concurrenthashmap_read_unlock(ConcurrentHashMap *map, size_t shard);
+
+// Capacity :
+
+bool concurrenthashmap_empty(ConcurrentHashMap *map);
+size_t concurrenthashmap_size(ConcurrentHashMap *map);
+
+// Modifiers :
+
+void concurrenthashmap_add(ConcurrentHashMap *map, void *key);
+void concurrenthashmap_set(ConcurrentHashMap *map, void *key, void *value);
+void concurrenthashmap_remove(ConcurrentHashMap *map, void *key);
+
+// ==== End of Method Overview ====
+
+// Private methods
+
+// The shards' HashMaps place entries with the low hash bits, the shard comes from the high ones
+static size_t concurrenthashmap_shard_of(ConcurrentHashMap *map, size_t hash) {
+    if (map->shard_bits == 0) {
+        return 0;
+    }
+    return hash >> (sizeof(size_t) * 8 - map->shard_bits);
+}
+
+// End of private methods
+
+// shard_count is rounded up to a power of two, 0 uses CONCURRENTHASHMAP_DEFAULT_SHARDS
+ConcurrentHashMap *concurrenthashmap_create(type_methods *key_methods, type_methods *value_methods, size_t shard_count) {
+    ConcurrentHashMap *map = malloc(sizeof(ConcurrentHashMap));
+    if (map == NULL) {
+        return NULL;
+    }
+    if (shard_count == 0) {
+        shard_count = CONCURRENTHASHMAP_DEFAULT_SHARDS;
+    }
+    map->shard_count = 1;
+    map->shard_bits = 0;
+    while (map->shard_count < shard_count) {
+        map->shard_count *= 2;
+        map->shard_bits++;
+    }
+    map->key_methods = key_methods;
+    map->value_methods = value_methods;
+
+    map->shards = aligned_alloc(CONCURRENTHASHMAP_SHARD_ALIGNMENT, map->shard_count * sizeof(ConcurrentHashMapShard));
+    if (map->shards == NULL) {
+        free(map);
+        return NULL;
+    }
+    for (size_t i = 0; i < map->shard_count; i++) {
+        map->shards[i].map = hashmap_create(key_methods, value_methods);
+        if (map->shards[i].map == NULL || pthread_rwlock_init(&map->shards[i].lock, NULL) != 0) {
+            hashmap_destroy(map->shards[i].map);
+            map->shard_count = i;
+            concurrenthashmap_destroy(map);
+            return NULL;
+        }
+        // Keys are hashed once with the first shard, so the shards share its seed and never reseed
+        hashmap_set_watchdog(map->shards[i].map, false);
+        if (i > 0) {
+            hashmap_reseed(map->shards[i].map, map->shards[0].map->seed);
+        }
+    }
+    return map;
+}
+
+// Must not race with any other operation on the map
+void concurrenthashmap_destroy(ConcurrentHashMap *map) {
+    if (map == NULL) {
+        return;
+    }
+    for (size_t i = 0; i < map->shard_count; i++) {
+        pthread_rwlock_destroy(&map->shards[i].lock);
+        hashmap_destroy(map->shards[i].map);
+    }
+    free(map->shards);
+    free(map);
+}
+
+// The value may be replaced or removed by another thread as soon as the shard is unlocked,
+// so this returns a duplicate made with the value methods that the caller has to destroy.
+void *concurrenthashmap_get(ConcurrentHashMap *map, void *key) {
+    size_t hash = hashmap_hash(map->shards[0].map, key);
+    ConcurrentHashMapShard *shard = &map->shards[concurrenthashmap_shard_of(map, hash)];
+    pthread_rwlock_rdlock(&shard->lock);
+    void *value = hashmap_get_hashed(shard->map, key, hash);
+    if (value != NULL) {
+        value = USE_DUP(map->value_methods, value);
+    }
+    pthread_rwlock_unlock(&shard->lock);
+    return value;
+}
+
+bool concurrenthashmap_contains(ConcurrentHashMap *map, void *key) {
+    size_t hash = hashmap_hash(map->shards[0].map, key);
+    ConcurrentHashMapShard *shard = &map->shards[concurrenthashmap_shard_of(map, hash)];
+    pthread_rwlock_rdlock(&shard->lock);
+    bool found = hashmap_contains_hashed(shard->map, key, hash);
+    pthread_rwlock_unlock(&shard->lock);
+    return found;
+}
+
+// Gives read access to one shard until concurrenthashmap_read_unlock, used for iteration
+HashMap *concurrenthashmap_read_lock(ConcurrentHashMap *map, size_t shard) {
+    pthread_rwlock_rdlock(&map->shards[shard].lock);
+    return map->shards[shard].map;
+}
+
+void concurrenthashmap_read_unlock(ConcurrentHashMap *map, size_t shard) {
+    pthread_rwlock_unlock(&map->shards[shard].lock);
+}
+
+bool concurrenthashmap_empty(ConcurrentHashMap *map) {
+    return concurrenthashmap_size(map) == 0;
+}
+
+// Sum of the shard sizes, each read under its own lock
+size_t concurrenthashmap_size(ConcurrentHashMap *map) {
+    size_t size = 0;
+    for (size_t i = 0; i < map->shard_count; i++) {
+        pthread_rwlock_rdlock(&map->shards[i].lock);
+        size += hashmap_size(map->shards[i].map);
+        pthread_rwlock_unlock(&map->shards[i].lock);
+    }
+    return size;
+}
+
+void concurrenthashmap_add(ConcurrentHashMap *map, void *key) {
+    size_t hash = hashmap_hash(map->shards[0].map, key);
+    ConcurrentHashMapShard *shard = &map->shards[concurrenthashmap_shard_of(map, hash)];
+    pthread_rwlock_wrlock(&shard->lock);
+    hashmap_add(shard->map, key);
+    pthread_rwlock_unlock(&shard->lock);
+}
+
+void concurrenthashmap_set(ConcurrentHashMap *map, void *key, void *value) {
+    size_t hash = hashmap_hash(map->shards[0].map, key);
+    ConcurrentHashMapShard *shard = &map->shards[concurrenthashmap_shard_of(map, hash)];
+    pthread_rwlock_wrlock(&shard->lock);
+    hashmap_set_hashed(shard->map, key, hash, value);
+    pthread_rwlock_unlock(&shard->lock);
+}
+
+void concurrenthashmap_remove(ConcurrentHashMap *map, void *key) {
+    size_t hash = hashmap_hash(map->shards[0].map, key);
+    ConcurrentHashMapShard *shard = &map->shards[concurrenthashmap_shard_of(map, hash)];
+    pthread_rwlock_wrlock(&shard->lock);
+    hashmap_remove_hashed(shard->map, key, hash);
+    pthread_rwlock_unlock(&shard->lock);
+}
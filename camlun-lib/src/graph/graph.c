@@ -77,6 +77,26 @@ static void graph_edges_vertex_remove(Graph *this, GraphVertexNode *node) {
     return;
 }
 
+// Add the edge to the adjacency lists of both vertices
+static void graph_adjacency_lists_connect(GraphVertexNode *from_vertex, GraphVertexNode *to_vertex) {
+    linkedlist_push_front(from_vertex->out_gv_nodes, to_vertex);
+    linkedlist_push_front(to_vertex->in_gv_nodes, from_vertex);
+}
+
+// Find the vertex of id, creating it with a default value if it does not exist yet
+static GraphVertexNode *graph_vertex_entry(Graph *this, void *id) {
+    bool inserted;
+    void *entry = hashmap_entry(this->vertices, id, &inserted);
+    if (!inserted) {
+        return hashmap_entry_value(this->vertices, entry);
+    }
+    GraphVertexNode *vertex_node = graphvertexnode_create(this);
+    hashmap_entry_set(this->vertices, entry, vertex_node);
+    vertex_node->id = hashmap_entry_key(this->vertices, entry); // vertex node has no ownership of id
+    this->vertex_count++;
+    return vertex_node;
+}
+
 // Remove the vertex from any adjacency lists
 static void graph_adjacency_lists_vertex_remove(Graph *this, GraphVertexNode *node) {
 
@@ -92,6 +112,11 @@ static void graph_adjacency_lists_vertex_remove(Graph *this, GraphVertexNode *no
 }
 
 Graph *graph_create(type_methods *id_methods, type_methods *value_methods) {
+    return graph_create_with_capacity(id_methods, value_methods, 0, 0);
+}
+
+// The counts are hints : a graph loaded with at most that many vertices and edges never rehashes
+Graph *graph_create_with_capacity(type_methods *id_methods, type_methods *value_methods, size_t vertex_count, size_t edge_count) {
     Graph *graph = malloc(sizeof(Graph));
     if (graph == NULL) {
         return NULL;
@@ -99,16 +124,18 @@ Graph *graph_create(type_methods *id_methods, type_methods *value_methods) {
     graph->id_methods = id_methods;
     graph->value_methods = value_methods;
 
-    graph->vertices = hashmap_create(id_methods, NULL);
+    graph->vertices = hashmap_create_dense(id_methods, NULL);
     if (graph->vertices == NULL) {
         free(graph);
         return NULL;
     }
+    hashmap_reserve(graph->vertices, vertex_count);
 
     graph->edges = NULL;
 
     graph->vertex_count = 0;
     graph->edge_count = 0;
+    graph->edge_capacity = edge_count;
 
     return graph;
 }
@@ -137,7 +164,8 @@ void graph_init_edges(Graph *this) {
     if (this->edges != NULL) {
         return;
     }
-    this->edges = hashmap_create(&TYPE_GRAPHEDGEKEY, this->value_methods);
+    size_t edge_capacity = this->edge_count > this->edge_capacity ? this->edge_count : this->edge_capacity;
+    this->edges = hashmap_create_with_capacity(&TYPE_GRAPHEDGEKEY, this->value_methods, edge_capacity);
     HASHMAP_VALUES_FOREACH(this->vertices, GraphVertexNode * from_vertex, {
         LINKEDLIST_FOREACH(from_vertex->out_gv_nodes, GraphVertexNode *to_vertex, {
             // printf("Adding edge from %s to %s\n", from_vertex->id, to_vertex->id);
@@ -220,22 +248,14 @@ bool graph_adjacent(Graph *this, void *from, void *to) {
 }
 
 void graph_add(Graph *this, void *id) {
-    GraphVertexNode *vertex_node = graphvertexnode_create(this);
-    // if (vertex_node == NULL) {
-    //     graphvertexnode_destroy(this, vertex_node);
-    //     return;
-    // }
-    hashmap_set(this->vertices, id, vertex_node);
-    void *key_ref = hashmap_get_key(this->vertices, id);
-    vertex_node->id = key_ref; // vertex node has no ownership of id
-    this->vertex_count++;
+    graph_vertex_entry(this, id);
 }
 
 void graph_remove(Graph *this, void *id) {
-    if(!hashmap_contains(this->vertices, id)) {
+    GraphVertexNode *vertex_node = hashmap_get(this->vertices, id);
+    if(vertex_node == NULL) {
         return;
     }
-    GraphVertexNode *vertex_node = hashmap_get(this->vertices, id);
     if(this->edges != NULL) {
         graph_edges_vertex_remove(this, vertex_node);
     }
@@ -250,20 +270,17 @@ void graph_remove(Graph *this, void *id) {
 }
 
 void graph_set(Graph *this, void *id, void *value) {
-    if(!hashmap_contains(this->vertices, id)) {
-        graph_add(this, id);
-    }
-    GraphVertexNode *vertex_node = hashmap_get(this->vertices, id);
+    GraphVertexNode *vertex_node = graph_vertex_entry(this, id);
     USE_DEL(this->value_methods, vertex_node->value);
     vertex_node->value = USE_DUP(this->value_methods, value);
     return;
 }
 
 void graph_reset(Graph *this, void *id) {
-    if(!hashmap_contains(this->vertices, id)) {
+    GraphVertexNode *vertex_node = hashmap_get(this->vertices, id);
+    if(vertex_node == NULL) {
         return;
     }
-    GraphVertexNode *vertex_node = hashmap_get(this->vertices, id);
     USE_DEL(this->value_methods, vertex_node->value);
     vertex_node->value = USE_CRT(this->value_methods);
 }
@@ -272,13 +289,12 @@ void graph_connect(Graph *this, void *from, void *to) {
     #if DEBUG
     // printf("Connecting %s to %s\n", from, to);
     #endif
-    assert(hashmap_contains(this->vertices, from));
-    assert(hashmap_contains(this->vertices, to));
     GraphVertexNode *from_vertex = hashmap_get(this->vertices, from);
     GraphVertexNode *to_vertex = hashmap_get(this->vertices, to);
+    assert(from_vertex != NULL);
+    assert(to_vertex != NULL);
 
-    linkedlist_push_front(from_vertex->out_gv_nodes, to_vertex);
-    linkedlist_push_front(to_vertex->in_gv_nodes, from_vertex);
+    graph_adjacency_lists_connect(from_vertex, to_vertex);
 
     if(this->edges != NULL) {
         GraphEdgeKey key = {.from = from_vertex, .to = to_vertex};
@@ -289,10 +305,10 @@ void graph_connect(Graph *this, void *from, void *to) {
 }
 
 void graph_disconnect(Graph *this, void *from, void *to) {
-    assert(hashmap_contains(this->vertices, from));
-    assert(hashmap_contains(this->vertices, to));
     GraphVertexNode *from_vertex = hashmap_get(this->vertices, from);
     GraphVertexNode *to_vertex = hashmap_get(this->vertices, to);
+    assert(from_vertex != NULL);
+    assert(to_vertex != NULL);
     if (this->edges != NULL) {
         GraphEdgeKey key = {.from = from_vertex, .to = to_vertex};
         hashmap_remove(this->edges, &key);
@@ -304,31 +320,32 @@ void graph_disconnect(Graph *this, void *from, void *to) {
 }
 
 void graph_assign(Graph *this, void *from, void *to, void *value) {
-    assert(hashmap_contains(this->vertices, from));
-    assert(hashmap_contains(this->vertices, to));
+    GraphVertexNode *from_vertex = hashmap_get(this->vertices, from);
+    GraphVertexNode *to_vertex = hashmap_get(this->vertices, to);
+    assert(from_vertex != NULL);
+    assert(to_vertex != NULL);
     if(this->edges == NULL) {
         graph_init_edges(this);
     }
-    if(!graph_adjacent(this, from, to)) {
-        graph_connect(this, from, to);
-    }
-    GraphVertexNode *from_vertex = hashmap_get(this->vertices, from);
-    GraphVertexNode *to_vertex = hashmap_get(this->vertices, to);
+    // A new edge key means the vertices were not adjacent yet
+    bool inserted;
     GraphEdgeKey key = {.from = from_vertex, .to = to_vertex};
-    hashmap_set(this->edges, &key, value);
+    void *entry = hashmap_entry(this->edges, &key, &inserted);
+    if(inserted) {
+        graph_adjacency_lists_connect(from_vertex, to_vertex);
+        this->edge_count++;
+    }
+    hashmap_entry_set(this->edges, entry, value);
     return;
 }
 
 void graph_unassign(Graph *this, void *from, void *to) {
-    assert(hashmap_contains(this->vertices, from));
-    assert(hashmap_contains(this->vertices, to));
-    if(this->edges == NULL) { return; }
     GraphVertexNode *from_vertex = hashmap_get(this->vertices, from);
     GraphVertexNode *to_vertex = hashmap_get(this->vertices, to);
+    assert(from_vertex != NULL);
+    assert(to_vertex != NULL);
+    if(this->edges == NULL) { return; }
     GraphEdgeKey key = {.from = from_vertex, .to = to_vertex};
-    if(!hashmap_contains(this->edges, &key)) {
-        return;
-    }
     hashmap_reset(this->edges, &key);
 }
 
@@ -36,5 +36,5 @@ int graphedgekey_comparator(void *first, void *second) {
 }
 
 size_t graphedgekey_hash_function(void *ptr) {
-    return numerical_hash_function(sizeof(GraphEdgeKey), ptr);
+    return numerical_hash_inline(sizeof(GraphEdgeKey), ptr);
 }
\ No newline at end of file
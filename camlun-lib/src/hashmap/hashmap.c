@@ -1,25 +1,90 @@
 #include "hashmap.h"
 
 #include <assert.h>
+#include <stdatomic.h>
 #include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
 #include <stdlib.h>
+#include <string.h>
+#include <sys/random.h>
+#include <time.h>
+
+#include "siphash.h"
+
+#if defined(__SSE2__) && !defined(HASHMAP_NO_SIMD)
+#include <emmintrin.h>
+#define HASHMAP_USE_SSE2 1
+#endif
 
 // ==== Method Overview ====
 
 // Private Methods :
 
-size_t hashmap_probe_next(size_t capacity, size_t index, size_t probe_count);
+static uint32_t hashmap_group_match(const unsigned char *group, unsigned char h2);
+static uint32_t hashmap_group_match_free(const unsigned char *group);
+static uint32_t hashmap_group_match_free_or_deleted(const unsigned char *group);
+static void hashmap_store_ctrl(unsigned char *ctrl, size_t capacity, size_t index, unsigned char value);
+static void hashmap_set_ctrl(HashMap *map, size_t index, unsigned char ctrl);
+static size_t hashmap_probe_next(HashMap *map, size_t pos, size_t *stride, size_t mask);
+static size_t hashmap_displacement(HashMap *map, size_t index, size_t hash);
+static size_t hashmap_probe_length(HashMap *map, size_t index, size_t hash);
+static uint64_t hashmap_mix(uint64_t value);
+static uint64_t hashmap_secret_word(void);
+static uint64_t hashmap_random_seed(void);
+static void hashmap_watchdog(HashMap *map);
+static unsigned char *hashmap_node(HashMap *map, size_t index);
+static int hashmap_compare_keys(HashMap *map, void *first, void *second);
+static unsigned char *hashmap_find_in(HashMap *map, unsigned char *nodes, unsigned char *ctrl, size_t capacity, void *key, size_t hash);
+static unsigned char *hashmap_slot_entry(HashMap *map, unsigned char *slot);
+static unsigned char *hashmap_find(HashMap *map, void *key, size_t hash);
+static unsigned char *hashmap_find_entry(HashMap *map, void *key, size_t hash);
+static unsigned char *hashmap_find_or_insert(HashMap *map, void *key, size_t hash, bool *inserted, bool adopt_key);
+static bool hashmap_remove_entry(HashMap *map, void *key, size_t hash, void **out_key, void **out_value);
+static size_t hashmap_find_insert_index(HashMap *map, size_t hash);
+static size_t hashmap_robin_hood_insert_index(HashMap *map, size_t hash);
+static size_t hashmap_claim_index(HashMap *map, size_t hash);
+static size_t hashmap_insert_index(HashMap *map, size_t hash);
+static size_t hashmap_round_capacity(size_t capacity);
+static size_t hashmap_capacity_for(size_t size);
+static void hashmap_grow(HashMap *map);
+static void hashmap_migrate(HashMap *map, size_t budget);
+static size_t hashmap_migration_step(HashMap *map);
+static bool hashmap_was_never_full(HashMap *map, size_t index);
+static void hashmap_backward_shift(HashMap *map, size_t hole);
+static void hashmap_purge_tombstones(HashMap *map);
+static size_t hashmap_field_alignment(size_t size);
+static bool hashmap_dense_reserve(HashMap *map);
+static void hashmap_dense_rebuild(HashMap *map, size_t capacity);
+static bool hashmap_dense_resize_entries(HashMap *map, size_t entry_capacity);
+static void hashmap_shrink(HashMap *map, size_t capacity);
+static void hashmap_filter_rebuild(HashMap *map, double false_positive_rate);
+static HashMap *hashmap_create_layout(type_methods *key_methods, type_methods *value_methods, hashmap_probe probe, size_t key_size, size_t value_size, bool dense, size_t capacity);
 bool hashmap_need_rehash(HashMap *map, size_t new_size);
 
 // Constructors and destructors :
 
 HashMap *hashmap_create(type_methods *key_methods, type_methods *value_methods);
+HashMap *hashmap_create_with_probe(type_methods *key_methods, type_methods *value_methods, hashmap_probe probe);
+HashMap *hashmap_create_with_capacity(type_methods *key_methods, type_methods *value_methods, size_t expected_size);
+HashMap *hashmap_create_inline(type_methods *key_methods, size_t key_size, size_t value_size);
+HashMap *hashmap_create_dense(type_methods *key_methods, type_methods *value_methods);
+HashMap *hashmap_create_inline_dense(type_methods *key_methods, size_t key_size, size_t value_size);
+HashMap *hashmap_create_keys(type_methods *key_methods);
 void hashmap_destroy(HashMap *this);
 
 // Access and iteration :
 
+size_t hashmap_hash(HashMap *map, void *key);
 void *hashmap_get(HashMap *map, void *key);
+void *hashmap_get_hashed(HashMap *map, void *key, size_t hash);
+size_t hashmap_get_many(HashMap *map, void **keys, size_t n, void **out_values);
 bool hashmap_contains(HashMap *map, void *key);
+bool hashmap_contains_hashed(HashMap *map, void *key, size_t hash);
+void *hashmap_entry(HashMap *map, void *key, bool *inserted);
+void *hashmap_entry_key(HashMap *map, void *entry);
+void *hashmap_entry_value(HashMap *map, void *entry);
+void hashmap_entry_set(HashMap *map, void *entry, void *value);
 
 // Capacity :
 
@@ -29,30 +94,634 @@ size_t hashmap_occupied_size(HashMap *map);
 size_t hashmap_capacity(HashMap *map);
 
 void hashmap_rehash(HashMap *map, size_t new_capacity);
+void hashmap_reserve(HashMap *map, size_t size);
+void hashmap_shrink_to_fit(HashMap *map);
+void hashmap_set_shrink_threshold(HashMap *map, double load_factor);
+void hashmap_set_migration_budget(HashMap *map, size_t budget);
+bool hashmap_migrating(HashMap *map);
+
+void hashmap_reseed(HashMap *map, uint64_t seed);
+void hashmap_set_watchdog(HashMap *map, bool enabled);
+
+void hashmap_attach_filter(HashMap *map, double false_positive_rate);
+void hashmap_detach_filter(HashMap *map);
 
 // Modifiers :
 
 void hashmap_set(HashMap *map, void *key, void *value);
+void hashmap_set_hashed(HashMap *map, void *key, size_t hash, void *value);
+void hashmap_set_owned(HashMap *map, void *key, void *value);
 void hashmap_reset(HashMap *map, void *key);
 void hashmap_remove(HashMap *map, void *key);
+void hashmap_remove_hashed(HashMap *map, void *key, size_t hash);
+bool hashmap_take(HashMap *map, void *key, void **out_key, void **out_value);
+void hashmap_clear(HashMap *map);
+
+// Copy constructors and creators :
+
+HashMap *hashmap_clone(HashMap *map, type_methods *new_data_methods);
 
 // Macros
 
+// H1 selects the first group to probe, H2 is stored in the control byte
+#define HASHMAP_H1(hash) ((hash) >> 7)
+#define HASHMAP_H2(hash) ((unsigned char)((hash) & 0x7F))
+
 // === End of Method Overview ===
 
 // Private methods
 
-size_t hashmap_probe_next(size_t capacity, size_t index, size_t probe_count) {
-    return (index + probe_count * probe_count) % capacity;
+// Each bit i of the returned mask is set when group[i] matches.
+static uint32_t hashmap_group_match(const unsigned char *group, unsigned char h2) {
+#ifdef HASHMAP_USE_SSE2
+    __m128i ctrl = _mm_loadu_si128((const __m128i *)group);
+    return (uint32_t)_mm_movemask_epi8(_mm_cmpeq_epi8(ctrl, _mm_set1_epi8((char)h2)));
+#else
+    uint32_t mask = 0;
+    for (size_t i = 0; i < HASHMAP_GROUP_WIDTH; i++) {
+        mask |= (uint32_t)(group[i] == h2) << i;
+    }
+    return mask;
+#endif
 }
 
-bool hashmap_need_rehash(HashMap *map, size_t new_size) {
-    return (double)new_size / map->capacity > HASHMAP_LOAD_FACTOR;
+static uint32_t hashmap_group_match_free(const unsigned char *group) {
+    return hashmap_group_match(group, HASHMAP_CTRL_FREE);
 }
 
-// End of private methods
+static uint32_t hashmap_group_match_free_or_deleted(const unsigned char *group) {
+#ifdef HASHMAP_USE_SSE2
+    // Free and deleted are the only control bytes with the high bit set
+    return (uint32_t)_mm_movemask_epi8(_mm_loadu_si128((const __m128i *)group));
+#else
+    uint32_t mask = 0;
+    for (size_t i = 0; i < HASHMAP_GROUP_WIDTH; i++) {
+        mask |= (uint32_t)!HASHMAP_CTRL_FILLED(group[i]) << i;
+    }
+    return mask;
+#endif
+}
 
-HashMap *hashmap_create(type_methods *key_methods, type_methods *value_methods) {
+// Keeps the mirrored tail in sync so a group load never has to wrap around
+static void hashmap_store_ctrl(unsigned char *ctrl, size_t capacity, size_t index, unsigned char value) {
+    ctrl[index] = value;
+    if (index < HASHMAP_GROUP_WIDTH) {
+        ctrl[capacity + index] = value;
+    }
+}
+
+static void hashmap_set_ctrl(HashMap *map, size_t index, unsigned char ctrl) {
+    hashmap_store_ctrl(map->ctrl, map->capacity, index, ctrl);
+}
+
+static unsigned char *hashmap_ctrl_create(size_t capacity) {
+    unsigned char *ctrl = malloc(capacity + HASHMAP_GROUP_WIDTH);
+    if (ctrl == NULL) {
+        return NULL;
+    }
+    memset(ctrl, HASHMAP_CTRL_FREE, capacity + HASHMAP_GROUP_WIDTH);
+    return ctrl;
+}
+
+// Triangular strides (16, 32, 48, ...) reach every group of a power-of-two table,
+// linear and robin hood probing walk consecutive groups.
+static size_t hashmap_probe_next(HashMap *map, size_t pos, size_t *stride, size_t mask) {
+    *stride = map->probe == HASHMAP_PROBE_TRIANGULAR ? *stride + HASHMAP_GROUP_WIDTH : HASHMAP_GROUP_WIDTH;
+    return (pos + *stride) & mask;
+}
+
+// Distance of a slot from the home slot of the hash stored in it
+static size_t hashmap_displacement(HashMap *map, size_t index, size_t hash) {
+    return (index - HASHMAP_H1(hash)) & (map->capacity - 1);
+}
+
+// Number of groups probed before the one holding the slot at index
+static size_t hashmap_probe_length(HashMap *map, size_t index, size_t hash) {
+    if (map->probe != HASHMAP_PROBE_TRIANGULAR) {
+        return hashmap_displacement(map, index, hash) / HASHMAP_GROUP_WIDTH;
+    }
+    size_t mask = map->capacity - 1;
+    size_t pos = HASHMAP_H1(hash) & mask;
+    size_t stride = 0;
+    size_t length = 0;
+    while (((index - pos) & mask) >= HASHMAP_GROUP_WIDTH) {
+        pos = hashmap_probe_next(map, pos, &stride, mask);
+        length++;
+    }
+    return length;
+}
+
+static unsigned char *hashmap_node(HashMap *map, size_t index) {
+    return HASHMAP_NODE_AT(map, map->nodes, index);
+}
+
+// MurmurHash3 finalizer, every input bit affects every output bit
+static uint64_t hashmap_mix(uint64_t value) {
+    value ^= value >> 33;
+    value *= 0xFF51AFD7ED558CCDULL;
+    value ^= value >> 33;
+    value *= 0xC4CEB9FE1A85EC53ULL;
+    value ^= value >> 33;
+    return value;
+}
+
+// Read once from the system entropy source, falling back to the clock and the address space layout
+static uint64_t hashmap_secret_word(void) {
+    uint64_t word = 0;
+    if (getrandom(&word, sizeof(word), 0) == sizeof(word)) {
+        return word;
+    }
+    FILE *urandom = fopen("/dev/urandom", "rb");
+    if (urandom != NULL) {
+        size_t words = fread(&word, sizeof(word), 1, urandom);
+        fclose(urandom);
+        if (words == 1) {
+            return word;
+        }
+    }
+    return hashmap_mix((uint64_t)time(NULL) ^ (uint64_t)clock() ^ (uint64_t)(uintptr_t)&word);
+}
+
+// Seeds are SipHash of a counter keyed by a process secret, so one seed gives away neither the secret nor any other seed
+static uint64_t hashmap_random_seed(void) {
+    static _Atomic uint64_t secret[2] = {0, 0};
+    static _Atomic uint64_t counter = 0;
+    uint64_t key[2];
+    for (size_t i = 0; i < 2; i++) {
+        key[i] = atomic_load(&secret[i]);
+        if (key[i] == 0) {
+            uint64_t expected = 0;
+            uint64_t word = hashmap_secret_word() | 1;
+            key[i] = atomic_compare_exchange_strong(&secret[i], &expected, word) ? word : expected;
+        }
+    }
+    uint64_t count = counter++;
+    return siphash13(&count, sizeof(count), key[0], key[1]);
+}
+
+// Reseeds once the last insertion reported a pathological probe sequence. Only called
+// before a key is hashed, so that neither a hash nor an entry handed out goes stale.
+static void hashmap_watchdog(HashMap *map) {
+    if (map->reseed_pending) {
+        map->reseed_pending = false;
+        hashmap_reseed(map, hashmap_random_seed());
+    }
+}
+
+// Keys are hashed with the seeded hash of their type methods, or of their built-in type, so that keys colliding
+// under one seed do not collide under another. Only for user types without a seeded hash is the seed mixed into
+// their hash, which keeps equal hashes equal. Inline keys without type methods are hashed byte by byte.
+size_t hashmap_hash(HashMap *map, void *key) {
+    if (map->seeded_hash != NULL) {
+        return map->seeded_hash(key, map->seed);
+    }
+    if (HASHMAP_INLINE(map) && (map->key_methods == NULL || map->key_methods->hash == NULL)) {
+        return numerical_seeded_hash_function(map->key_size, key, map->seed);
+    }
+    return hashmap_mix(USE_HASH(map->key_methods, key) ^ map->seed);
+}
+
+static int hashmap_compare_keys(HashMap *map, void *first, void *second) {
+    if (HASHMAP_INLINE(map) && (map->key_methods == NULL || map->key_methods->cmp == NULL)) {
+        return memcmp(first, second, map->key_size);
+    }
+    return USE_CMP(map->key_methods, first, second);
+}
+
+// Dense maps keep the key and value in the entries array, other maps in the slot itself
+static unsigned char *hashmap_slot_entry(HashMap *map, unsigned char *slot) {
+    return map->dense ? HASHMAP_ENTRY_AT(map, ((HashMapIndex *)slot)->entry) : slot;
+}
+
+// Only slots whose H2 and cached hash match reach the comparator.
+static unsigned char *hashmap_find_in(HashMap *map, unsigned char *nodes, unsigned char *ctrl, size_t capacity, void *key, size_t hash) {
+    unsigned char h2 = HASHMAP_H2(hash);
+    size_t mask = capacity - 1;
+    size_t pos = HASHMAP_H1(hash) & mask;
+    size_t stride = 0;
+    while (1) {
+        const unsigned char *group = ctrl + pos;
+        uint32_t matches = hashmap_group_match(group, h2);
+        while (matches) {
+            unsigned char *node = HASHMAP_NODE_AT(map, nodes, (pos + __builtin_ctz(matches)) & mask);
+            if (HASHMAP_NODE_HASH(node) == hash && hashmap_compare_keys(map, HASHMAP_NODE_KEY(map, hashmap_slot_entry(map, node)), key) == 0) {
+                return node;
+            }
+            matches &= matches - 1;
+        }
+        if (hashmap_group_match_free(group)) {
+            return NULL;
+        }
+        pos = hashmap_probe_next(map, pos, &stride, mask);
+    }
+}
+
+// Looks in the table being migrated away from as well, NULL if the key is absent
+static unsigned char *hashmap_find(HashMap *map, void *key, size_t hash) {
+    if (map->filter != NULL && !bloomfilter_contains_hash(map->filter, hash)) {
+        return NULL;
+    }
+    unsigned char *node = hashmap_find_in(map, map->nodes, map->ctrl, map->capacity, key, hash);
+    if (node == NULL && map->old_capacity != 0) {
+        node = hashmap_find_in(map, map->old_nodes, map->old_ctrl, map->old_capacity, key, hash);
+    }
+    return node;
+}
+
+static unsigned char *hashmap_find_entry(HashMap *map, void *key, size_t hash) {
+    unsigned char *slot = hashmap_find(map, key, hash);
+    return slot != NULL ? hashmap_slot_entry(map, slot) : NULL;
+}
+
+// Returns the entry of key, claiming one and copying the key in when it is absent, or storing the pointer as is with adopt_key.
+// The value of a claimed entry is left for the caller to fill in. NULL if no room could be made.
+static unsigned char *hashmap_find_or_insert(HashMap *map, void *key, size_t hash, bool *inserted, bool adopt_key) {
+    unsigned char *node = hashmap_find_entry(map, key, hash);
+    *inserted = node == NULL;
+    if (node != NULL) {
+        return node;
+    }
+    if (map->dense) {
+        if (!hashmap_dense_reserve(map)) {
+            *inserted = false;
+            return NULL;
+        }
+        // Growing the table may compact the entries, so the new one is appended afterwards
+        HashMapIndex *slot = (HashMapIndex *)hashmap_node(map, hashmap_insert_index(map, hash));
+        slot->entry = map->entry_count;
+        node = HASHMAP_ENTRY_AT(map, map->entry_count);
+        map->entry_live[map->entry_count++] = true;
+        HASHMAP_NODE_HASH(node) = hash;
+    } else {
+        node = hashmap_node(map, hashmap_insert_index(map, hash));
+    }
+    if (HASHMAP_INLINE(map)) {
+        memcpy(node + map->key_offset, key, map->key_size);
+    } else {
+        ((HashMapNode *)node)->key = adopt_key ? key : USE_DUP(map->key_methods, key);
+    }
+    if (map->filter != NULL) {
+        bloomfilter_add_hash(map->filter, hash);
+        // Past its sizing, or saturated by removed keys, the filter would stop answering no
+        if (bloomfilter_size(map->filter) > bloomfilter_capacity(map->filter)) {
+            hashmap_filter_rebuild(map, map->filter->false_positive_rate);
+        }
+    }
+    return node;
+}
+
+// First free or deleted slot on the probe sequence of hash
+static size_t hashmap_find_insert_index(HashMap *map, size_t hash) {
+    size_t mask = map->capacity - 1;
+    size_t pos = HASHMAP_H1(hash) & mask;
+    size_t stride = 0;
+    while (1) {
+        uint32_t available = hashmap_group_match_free_or_deleted(map->ctrl + pos);
+        if (available) {
+            return (pos + __builtin_ctz(available)) & mask;
+        }
+        pos = hashmap_probe_next(map, pos, &stride, mask);
+    }
+}
+
+// Takes the slot from the first entry that sits closer to its home than the new key would,
+// then pushes the displaced entries forward until one lands on a free or deleted slot.
+static size_t hashmap_robin_hood_insert_index(HashMap *map, size_t hash) {
+    size_t mask = map->capacity - 1;
+    size_t index = HASHMAP_H1(hash) & mask;
+    size_t distance = 0;
+    while (HASHMAP_CTRL_FILLED(map->ctrl[index]) && hashmap_displacement(map, index, HASHMAP_NODE_HASH(hashmap_node(map, index))) >= distance) {
+        index = (index + 1) & mask;
+        distance++;
+    }
+    size_t target = index;
+    if (HASHMAP_CTRL_FILLED(map->ctrl[target])) {
+        unsigned char *carry = map->scratch;
+        unsigned char *swap = map->scratch + map->slot_size;
+        memcpy(carry, hashmap_node(map, target), map->slot_size);
+        size_t carry_distance = hashmap_displacement(map, target, HASHMAP_NODE_HASH(carry));
+        while (1) {
+            index = (index + 1) & mask;
+            carry_distance++;
+            if (!HASHMAP_CTRL_FILLED(map->ctrl[index])) {
+                break;
+            }
+            size_t existing_distance = hashmap_displacement(map, index, HASHMAP_NODE_HASH(hashmap_node(map, index)));
+            if (existing_distance < carry_distance) {
+                memcpy(swap, hashmap_node(map, index), map->slot_size);
+                memcpy(hashmap_node(map, index), carry, map->slot_size);
+                hashmap_set_ctrl(map, index, HASHMAP_H2(HASHMAP_NODE_HASH(carry)));
+                unsigned char *evicted = swap;
+                swap = carry;
+                carry = evicted;
+                carry_distance = existing_distance;
+            }
+        }
+        if (map->ctrl[index] == HASHMAP_CTRL_FREE) {
+            map->occupied_size++;
+        }
+        memcpy(hashmap_node(map, index), carry, map->slot_size);
+        hashmap_set_ctrl(map, index, HASHMAP_H2(HASHMAP_NODE_HASH(carry)));
+    } else if (map->ctrl[target] == HASHMAP_CTRL_FREE) {
+        map->occupied_size++;
+    }
+    return target;
+}
+
+// Reserves a slot for a hash that is known to be absent, the caller fills in key and value
+static size_t hashmap_claim_index(HashMap *map, size_t hash) {
+    size_t index;
+    if (map->probe == HASHMAP_PROBE_ROBIN_HOOD) {
+        index = hashmap_robin_hood_insert_index(map, hash);
+    } else {
+        index = hashmap_find_insert_index(map, hash);
+        if (map->ctrl[index] == HASHMAP_CTRL_FREE) {
+            map->occupied_size++;
+        }
+    }
+    hashmap_set_ctrl(map, index, HASHMAP_H2(hash));
+    HASHMAP_NODE_HASH(hashmap_node(map, index)) = hash;
+    return index;
+}
+
+static size_t hashmap_insert_index(HashMap *map, size_t hash) {
+    // Entries still waiting in the previous table will land in this one too
+    if (hashmap_need_rehash(map, map->occupied_size + map->old_size + 1)) {
+        hashmap_grow(map);
+    }
+    hashmap_migrate(map, hashmap_migration_step(map));
+    size_t index = hashmap_claim_index(map, hash);
+    map->size++;
+    // Reseeding cannot help keys whose hashes are equal, so it is tried once per capacity
+    if (map->watchdog && map->capacity != map->reseed_capacity && hashmap_probe_length(map, index, hash) > HASHMAP_PROBE_LIMIT) {
+        map->reseed_pending = true;
+    }
+    return index;
+}
+
+// Smallest power of two that is at least capacity and one group wide
+static size_t hashmap_round_capacity(size_t capacity) {
+    size_t rounded = HASHMAP_GROUP_WIDTH;
+    while (rounded < capacity) {
+        rounded *= 2;
+    }
+    return rounded;
+}
+
+// Smallest capacity holding size entries without growing
+static size_t hashmap_capacity_for(size_t size) {
+    size_t capacity = HASHMAP_GROUP_WIDTH;
+    while ((double)size / capacity > HASHMAP_LOAD_FACTOR) {
+        capacity *= 2;
+    }
+    return capacity;
+}
+
+// Doubles the capacity, or rebuilds at the current one when tombstones take up enough of it,
+// either at once or by keeping the current table around. The migration step has already emptied
+// the previous table by now, finishing it here only covers a grow whose new table could not be allocated.
+static void hashmap_grow(HashMap *map) {
+    hashmap_migrate(map, SIZE_MAX);
+
+    size_t new_capacity = map->capacity * 2;
+    if (map->occupied_size - map->size >= map->capacity * HASHMAP_TOMBSTONE_RATIO) {
+        new_capacity = map->capacity;
+    }
+    if (map->migration_budget == 0) {
+        hashmap_rehash(map, new_capacity);
+        return;
+    }
+
+    unsigned char *new_nodes = malloc(new_capacity * map->slot_size);
+    unsigned char *new_ctrl = hashmap_ctrl_create(new_capacity);
+    if (new_nodes == NULL || new_ctrl == NULL) {
+        free(new_nodes);
+        free(new_ctrl);
+        return;
+    }
+
+    map->old_nodes = map->nodes;
+    map->old_ctrl = map->ctrl;
+    map->old_capacity = map->capacity;
+    map->old_size = map->size;
+    map->migrate_index = 0;
+
+    map->nodes = new_nodes;
+    map->ctrl = new_ctrl;
+    map->capacity = new_capacity;
+    map->occupied_size = 0;
+}
+
+// Moves up to budget slots of the previous table. Moved slots become deleted rather than
+// free so the probe sequences of entries that have not moved yet stay intact.
+static void hashmap_migrate(HashMap *map, size_t budget) {
+    if (map->old_capacity == 0) {
+        return;
+    }
+    while (budget > 0 && map->migrate_index < map->old_capacity) {
+        size_t i = map->migrate_index++;
+        budget--;
+        if (!HASHMAP_CTRL_FILLED(map->old_ctrl[i])) {
+            continue;
+        }
+        unsigned char *node = HASHMAP_NODE_AT(map, map->old_nodes, i);
+        size_t index = hashmap_claim_index(map, HASHMAP_NODE_HASH(node));
+        memcpy(hashmap_node(map, index), node, map->slot_size);
+        hashmap_store_ctrl(map->old_ctrl, map->old_capacity, i, HASHMAP_CTRL_DELETED);
+        map->old_size--;
+    }
+    if (map->migrate_index == map->old_capacity) {
+        free(map->old_nodes);
+        free(map->old_ctrl);
+        map->old_nodes = NULL;
+        map->old_ctrl = NULL;
+        map->old_capacity = 0;
+        map->old_size = 0;
+    }
+}
+
+// Slots to move on this insert or remove, the budget or more. The insertions left before the next grow
+// share the slots left to move, so a migration never has to be finished at once by the next grow.
+static size_t hashmap_migration_step(HashMap *map) {
+    if (map->old_capacity == 0) {
+        return 0;
+    }
+    size_t remaining = map->old_capacity - map->migrate_index;
+    size_t limit = (size_t)(map->capacity * HASHMAP_LOAD_FACTOR);
+    size_t used = map->occupied_size + map->old_size;
+    size_t headroom = limit > used ? limit - used : 1;
+    size_t needed = (remaining + headroom - 1) / headroom;
+    return needed > map->migration_budget ? needed : map->migration_budget;
+}
+
+// A slot inside a run of fewer than a group of non-free slots was never part of a full group,
+// so no probe sequence has gone past it and it can be freed instead of left as a tombstone.
+static bool hashmap_was_never_full(HashMap *map, size_t index) {
+    size_t before = (index - HASHMAP_GROUP_WIDTH) & (map->capacity - 1);
+    uint32_t free_before = hashmap_group_match_free(map->ctrl + before);
+    uint32_t free_after = hashmap_group_match_free(map->ctrl + index);
+    if (free_before == 0 || free_after == 0) {
+        return false;
+    }
+    size_t run_before = __builtin_clz(free_before) - (32 - HASHMAP_GROUP_WIDTH);
+    size_t run_after = __builtin_ctz(free_after);
+    return run_before + run_after < HASHMAP_GROUP_WIDTH;
+}
+
+// Pulls later entries of the cluster back over the removed slot so no tombstone is left.
+// Robin hood shifts every displaced entry by one, linear probing only moves the entries
+// whose home slot does not lie between the hole and their current slot (Knuth's algorithm R).
+static void hashmap_backward_shift(HashMap *map, size_t hole) {
+    size_t mask = map->capacity - 1;
+    size_t index = hole;
+    while (1) {
+        index = (index + 1) & mask;
+        if (!HASHMAP_CTRL_FILLED(map->ctrl[index])) {
+            break;
+        }
+        size_t displacement = hashmap_displacement(map, index, HASHMAP_NODE_HASH(hashmap_node(map, index)));
+        if (map->probe == HASHMAP_PROBE_ROBIN_HOOD) {
+            if (displacement == 0) {
+                break;
+            }
+        } else if (displacement < ((index - hole) & mask)) {
+            continue;
+        }
+        memcpy(hashmap_node(map, hole), hashmap_node(map, index), map->slot_size);
+        hashmap_set_ctrl(map, hole, map->ctrl[index]);
+        hole = index;
+    }
+    hashmap_set_ctrl(map, hole, HASHMAP_CTRL_FREE);
+    map->occupied_size--;
+}
+
+// Same-capacity rehash without a second table. Tombstones become free and the filled slots are
+// marked deleted, then each marked entry is placed on its probe sequence, swapping with a marked
+// entry that has not been placed yet when needed.
+static void hashmap_purge_tombstones(HashMap *map) {
+    size_t mask = map->capacity - 1;
+    for (size_t i = 0; i < map->capacity; i++) {
+        map->ctrl[i] = HASHMAP_CTRL_FILLED(map->ctrl[i]) ? HASHMAP_CTRL_DELETED : HASHMAP_CTRL_FREE;
+    }
+    memcpy(map->ctrl + map->capacity, map->ctrl, HASHMAP_GROUP_WIDTH);
+
+    size_t i = 0;
+    while (i < map->capacity) {
+        if (map->ctrl[i] != HASHMAP_CTRL_DELETED) {
+            i++;
+            continue;
+        }
+        size_t hash = HASHMAP_NODE_HASH(hashmap_node(map, i));
+        size_t home = HASHMAP_H1(hash) & mask;
+        size_t target = hashmap_find_insert_index(map, hash);
+        // Probe groups start at multiples of the group width from home, staying in the same one is enough
+        if (((i - home) & mask) / HASHMAP_GROUP_WIDTH == ((target - home) & mask) / HASHMAP_GROUP_WIDTH) {
+            hashmap_set_ctrl(map, i, HASHMAP_H2(hash));
+            i++;
+            continue;
+        }
+        if (map->ctrl[target] == HASHMAP_CTRL_FREE) {
+            memcpy(hashmap_node(map, target), hashmap_node(map, i), map->slot_size);
+            hashmap_set_ctrl(map, i, HASHMAP_CTRL_FREE);
+            i++;
+        } else {
+            memcpy(map->scratch, hashmap_node(map, target), map->slot_size);
+            memcpy(hashmap_node(map, target), hashmap_node(map, i), map->slot_size);
+            memcpy(hashmap_node(map, i), map->scratch, map->slot_size);
+        }
+        hashmap_set_ctrl(map, target, HASHMAP_H2(hash));
+    }
+    map->occupied_size = map->size;
+}
+
+// Makes room for one more entry, reusing the room of removed entries once they are half the array
+static bool hashmap_dense_reserve(HashMap *map) {
+    if (map->entry_count < map->entry_capacity) {
+        return true;
+    }
+    if ((map->entry_count - map->size) * 2 >= map->entry_count) {
+        hashmap_dense_rebuild(map, map->capacity);
+        return map->entry_count < map->entry_capacity;
+    }
+    return hashmap_dense_resize_entries(map, map->entry_capacity * 2);
+}
+
+// Reallocates the entries array, which must stay large enough for entry_count
+static bool hashmap_dense_resize_entries(HashMap *map, size_t entry_capacity) {
+    unsigned char *entries = realloc(map->entries, entry_capacity * map->entry_size);
+    if (entries == NULL) {
+        return false;
+    }
+    map->entries = entries;
+    bool *entry_live = realloc(map->entry_live, entry_capacity * sizeof(bool));
+    if (entry_live == NULL) {
+        return false;
+    }
+    map->entry_live = entry_live;
+    map->entry_capacity = entry_capacity;
+    return true;
+}
+
+// Rebuilds the table at a smaller capacity, a dense map also gives back the room of its entries
+// beyond what the new table holds. The live entries are never squeezed past the load factor.
+static void hashmap_shrink(HashMap *map, size_t capacity) {
+    hashmap_rehash(map, capacity);
+    size_t entry_capacity = (size_t)(map->capacity * HASHMAP_LOAD_FACTOR);
+    if (map->dense && map->entry_capacity > entry_capacity && map->entry_count <= entry_capacity) {
+        hashmap_dense_resize_entries(map, entry_capacity);
+    }
+}
+
+// Drops removed entries while keeping the others in insertion order,
+// then indexes them again in a table of the given capacity.
+static void hashmap_dense_rebuild(HashMap *map, size_t capacity) {
+    if (capacity != map->capacity) {
+        unsigned char *new_nodes = malloc(capacity * map->slot_size);
+        unsigned char *new_ctrl = hashmap_ctrl_create(capacity);
+        if (new_nodes == NULL || new_ctrl == NULL) {
+            free(new_nodes);
+            free(new_ctrl);
+            return;
+        }
+        free(map->nodes);
+        free(map->ctrl);
+        map->nodes = new_nodes;
+        map->ctrl = new_ctrl;
+        map->capacity = capacity;
+    } else {
+        memset(map->ctrl, HASHMAP_CTRL_FREE, capacity + HASHMAP_GROUP_WIDTH);
+    }
+    map->occupied_size = 0;
+
+    size_t count = 0;
+    for (size_t i = 0; i < map->entry_count; i++) {
+        if (!map->entry_live[i]) {
+            continue;
+        }
+        if (count != i) {
+            memcpy(HASHMAP_ENTRY_AT(map, count), HASHMAP_ENTRY_AT(map, i), map->entry_size);
+            map->entry_live[count] = true;
+        }
+        size_t index = hashmap_claim_index(map, HASHMAP_NODE_HASH(HASHMAP_ENTRY_AT(map, count)));
+        ((HashMapIndex *)hashmap_node(map, index))->entry = count;
+        count++;
+    }
+    map->entry_count = count;
+}
+
+// Largest power of two dividing size, capped at the strictest fundamental alignment
+static size_t hashmap_field_alignment(size_t size) {
+    size_t alignment = 1;
+    while (size != 0 && alignment < _Alignof(max_align_t) && size % (alignment * 2) == 0) {
+        alignment *= 2;
+    }
+    return alignment;
+}
+
+// capacity must be a power of two of at least HASHMAP_GROUP_WIDTH.
+// key_size 0 stores a HashMapNode per entry, value_size then being sizeof(void *), or 0 for a map without values. Otherwise the cached hash is followed by the key and value bytes.
+// Entries sit in the slots themselves, or for dense maps in an array indexed by HashMapIndex slots.
+static HashMap *hashmap_create_layout(type_methods *key_methods, type_methods *value_methods, hashmap_probe probe, size_t key_size, size_t value_size, bool dense, size_t capacity) {
     HashMap *hashmap = malloc(sizeof(HashMap));
     if (hashmap == NULL) {
         return NULL;
@@ -61,128 +730,297 @@ HashMap *hashmap_create(type_methods *key_methods, type_methods *value_methods)
     hashmap->size = 0;
     hashmap->key_methods = key_methods;
     hashmap->value_methods = value_methods;
+    hashmap->probe = probe;
+
+    hashmap->key_size = key_size;
+    hashmap->value_size = value_size;
+    if (key_size == 0) {
+        // A map without values drops the value pointer from the end of its HashMapNode
+        hashmap->key_offset = offsetof(HashMapNode, key);
+        hashmap->value_offset = offsetof(HashMapNode, value);
+        hashmap->entry_size = value_size != 0 ? sizeof(HashMapNode) : offsetof(HashMapNode, value);
+    } else {
+        size_t key_alignment = hashmap_field_alignment(key_size);
+        size_t value_alignment = hashmap_field_alignment(value_size);
+        size_t slot_alignment = sizeof(size_t);
+        slot_alignment = key_alignment > slot_alignment ? key_alignment : slot_alignment;
+        slot_alignment = value_alignment > slot_alignment ? value_alignment : slot_alignment;
+        hashmap->key_offset = (sizeof(size_t) + key_alignment - 1) / key_alignment * key_alignment;
+        hashmap->value_offset = (hashmap->key_offset + key_size + value_alignment - 1) / value_alignment * value_alignment;
+        hashmap->entry_size = (hashmap->value_offset + value_size + slot_alignment - 1) / slot_alignment * slot_alignment;
+    }
+    hashmap->slot_size = dense ? sizeof(HashMapIndex) : hashmap->entry_size;
+
+    hashmap->old_nodes = NULL;
+    hashmap->old_ctrl = NULL;
+    hashmap->old_capacity = 0;
+    hashmap->old_size = 0;
+    hashmap->migrate_index = 0;
+    hashmap->migration_budget = 0;
+    hashmap->shrink_load_factor = 0;
+
+    hashmap->seed = hashmap_random_seed();
+    hashmap->seeded_hash = NULL;
+    if (key_methods != NULL) {
+        hashmap->seeded_hash = key_methods->seeded_hash != NULL ? key_methods->seeded_hash : builtin_seeded_hash_function(key_methods->hash);
+    }
+    hashmap->watchdog = true;
+    hashmap->reseed_pending = false;
+    hashmap->reseed_capacity = 0;
+    hashmap->filter = NULL;
+
+    hashmap->capacity = capacity;
+    hashmap->nodes = malloc(hashmap->capacity * hashmap->slot_size);
+    hashmap->ctrl = hashmap_ctrl_create(hashmap->capacity);
+    hashmap->scratch = malloc(2 * hashmap->slot_size);
 
-    hashmap->capacity = HASHMAP_INITIAL_CAPACITY;
-    hashmap->nodes = calloc(hashmap->capacity, sizeof(HashMapNode));
-    if (hashmap->nodes == NULL) {
+    hashmap->dense = dense;
+    hashmap->entries = NULL;
+    hashmap->entry_live = NULL;
+    hashmap->entry_count = 0;
+    hashmap->entry_capacity = 0;
+    if (dense) {
+        hashmap->entry_capacity = (size_t)(hashmap->capacity * HASHMAP_LOAD_FACTOR);
+        hashmap->entries = malloc(hashmap->entry_capacity * hashmap->entry_size);
+        hashmap->entry_live = malloc(hashmap->entry_capacity * sizeof(bool));
+    }
+    if (hashmap->nodes == NULL || hashmap->ctrl == NULL || hashmap->scratch == NULL ||
+        (dense && (hashmap->entries == NULL || hashmap->entry_live == NULL))) {
+        free(hashmap->nodes);
+        free(hashmap->ctrl);
+        free(hashmap->scratch);
+        free(hashmap->entries);
+        free(hashmap->entry_live);
         free(hashmap);
         return NULL;
     }
     return hashmap;
 }
 
+// Replaces the filter with one sized for twice the live keys, and at least for the table, holding their cached hashes
+static void hashmap_filter_rebuild(HashMap *map, double false_positive_rate) {
+    size_t expected = (size_t)(map->capacity * HASHMAP_LOAD_FACTOR);
+    expected = 2 * map->size > expected ? 2 * map->size : expected;
+    BloomFilter *filter = bloomfilter_create(NULL, expected, false_positive_rate);
+    bloomfilter_destroy(map->filter);
+    map->filter = filter;
+    if (filter == NULL) {
+        return;
+    }
+    for (size_t i = 0; i < HASHMAP_ITER_COUNT(map); i++) {
+        if (HASHMAP_ITER_LIVE(map, i)) {
+            bloomfilter_add_hash(filter, HASHMAP_NODE_HASH(HASHMAP_ITER_NODE(map, i)));
+        }
+    }
+}
+
+bool hashmap_need_rehash(HashMap *map, size_t new_size) {
+    return (double)new_size / map->capacity > HASHMAP_LOAD_FACTOR;
+}
+
+// End of private methods
+
+HashMap *hashmap_create(type_methods *key_methods, type_methods *value_methods) {
+    return hashmap_create_with_probe(key_methods, value_methods, HASHMAP_PROBE_TRIANGULAR);
+}
+
+HashMap *hashmap_create_with_probe(type_methods *key_methods, type_methods *value_methods, hashmap_probe probe) {
+    return hashmap_create_layout(key_methods, value_methods, probe, 0, sizeof(void *), false, HASHMAP_INITIAL_CAPACITY);
+}
+
+// Sized so that expected_size entries fit without growing
+HashMap *hashmap_create_with_capacity(type_methods *key_methods, type_methods *value_methods, size_t expected_size) {
+    return hashmap_create_layout(key_methods, value_methods, HASHMAP_PROBE_TRIANGULAR, 0, sizeof(void *), false, hashmap_capacity_for(expected_size));
+}
+
+// Keys and values are copied into the slots with memcpy, so they must not own other memory.
+// key_methods only supply the hash and comparator, without them keys are compared byte by byte.
+HashMap *hashmap_create_inline(type_methods *key_methods, size_t key_size, size_t value_size) {
+    assert(key_size > 0);
+    return hashmap_create_layout(key_methods, NULL, HASHMAP_PROBE_TRIANGULAR, key_size, value_size, false, HASHMAP_INITIAL_CAPACITY);
+}
+
+// Entries are kept in insertion order in a compact array and iterated in that order,
+// the table itself only holds hashes and entry positions. Dense maps always resize at once.
+HashMap *hashmap_create_dense(type_methods *key_methods, type_methods *value_methods) {
+    return hashmap_create_layout(key_methods, value_methods, HASHMAP_PROBE_TRIANGULAR, 0, sizeof(void *), true, HASHMAP_INITIAL_CAPACITY);
+}
+
+HashMap *hashmap_create_inline_dense(type_methods *key_methods, size_t key_size, size_t value_size) {
+    assert(key_size > 0);
+    return hashmap_create_layout(key_methods, NULL, HASHMAP_PROBE_TRIANGULAR, key_size, value_size, true, HASHMAP_INITIAL_CAPACITY);
+}
+
+// Slots only hold the cached hash and the key, values read as NULL and cannot be set. Used by HashSet.
+HashMap *hashmap_create_keys(type_methods *key_methods) {
+    return hashmap_create_layout(key_methods, NULL, HASHMAP_PROBE_TRIANGULAR, 0, 0, false, HASHMAP_INITIAL_CAPACITY);
+}
+
 void hashmap_destroy(HashMap *map) {
     if (map == NULL) {
         return;
     }
-    for (size_t i = 0; i < map->capacity; i++) {
-        if (map->nodes[i].status == HASHMAP_NODE_FILLED) {
+    if (!HASHMAP_INLINE(map)) {
+        HASHMAP_PAIRS_FOREACH(map, void *key, void *value, {
             #if DEBUG
-            // printf("Destroying %s\n", map->nodes[i].key);
+            // printf("Destroying %s\n", key);
             #endif
-            USE_DEL(map->key_methods, map->nodes[i].key);
-            USE_DEL(map->value_methods, map->nodes[i].value);
-        }
+            USE_DEL(map->key_methods, key);
+            USE_DEL(map->value_methods, value);
+        });
     }
     free(map->nodes);
+    free(map->ctrl);
+    free(map->scratch);
+    free(map->entries);
+    free(map->entry_live);
+    free(map->old_nodes);
+    free(map->old_ctrl);
+    bloomfilter_destroy(map->filter);
     free(map);
     return;
 }
 
+// For inline maps the result points into the table and is only valid until the next insert or remove
 void *hashmap_get(HashMap *map, void *key) {
-    size_t index = USE_HASH(map->key_methods, key) % map->capacity;
-    size_t probe_count = 0;
-    while (map->nodes[index].status != HASHMAP_NODE_FREE) {
-        if (map->nodes[index].status == HASHMAP_NODE_FILLED && USE_CMP(map->key_methods, map->nodes[index].key, key) == 0) {
-            return map->nodes[index].value;
+    return hashmap_get_hashed(map, key, hashmap_hash(map, key));
+}
+
+// hash must be hashmap_hash of key, for instance computed once for several maps with the same key methods and seed
+void *hashmap_get_hashed(HashMap *map, void *key, size_t hash) {
+    unsigned char *node = hashmap_find_entry(map, key, hash);
+    return node != NULL ? HASHMAP_NODE_VALUE(map, node) : NULL;
+}
+
+// Looks up n keys, storing each value (NULL when absent) in out_values and returning how many were found.
+// Keys are hashed and their first groups prefetched a batch at a time so the cache misses overlap.
+size_t hashmap_get_many(HashMap *map, void **keys, size_t n, void **out_values) {
+    size_t hashes[HASHMAP_BATCH_SIZE];
+    size_t found = 0;
+    size_t mask = map->capacity - 1;
+    for (size_t start = 0; start < n; start += HASHMAP_BATCH_SIZE) {
+        size_t count = n - start < HASHMAP_BATCH_SIZE ? n - start : HASHMAP_BATCH_SIZE;
+        for (size_t i = 0; i < count; i++) {
+            hashes[i] = hashmap_hash(map, keys[start + i]);
+            size_t pos = HASHMAP_H1(hashes[i]) & mask;
+            __builtin_prefetch(map->ctrl + pos);
+            __builtin_prefetch(hashmap_node(map, pos));
+        }
+        for (size_t i = 0; i < count; i++) {
+            out_values[start + i] = hashmap_get_hashed(map, keys[start + i], hashes[i]);
+            if (out_values[start + i] != NULL) {
+                found++;
+            }
         }
-        probe_count++;
-        index = hashmap_probe_next(map->capacity, index, probe_count);
     }
-    return NULL;
+    return found;
 }
 
 void *hashmap_get_key(HashMap *map, void *key) {
-    size_t index = USE_HASH(map->key_methods, key) % map->capacity;
-    size_t probe_count = 0;
-    while (map->nodes[index].status != HASHMAP_NODE_FREE) {
-        if (map->nodes[index].status == HASHMAP_NODE_FILLED && USE_CMP(map->key_methods, map->nodes[index].key, key) == 0) {
-            return map->nodes[index].key;
-        }
-        probe_count++;
-        index = hashmap_probe_next(map->capacity, index, probe_count);
-    }
-    return NULL;
+    unsigned char *node = hashmap_find_entry(map, key, hashmap_hash(map, key));
+    return node != NULL ? HASHMAP_NODE_KEY(map, node) : NULL;
 }
 
 bool hashmap_contains(HashMap *map, void *key) {
-    size_t index = USE_HASH(map->key_methods, key) % map->capacity;
-    size_t probe_count = 0;
-    while (map->nodes[index].status != HASHMAP_NODE_FREE) {
-        if (map->nodes[index].status == HASHMAP_NODE_FILLED && USE_CMP(map->key_methods, map->nodes[index].key, key) == 0) {
-            return true;
+    return hashmap_contains_hashed(map, key, hashmap_hash(map, key));
+}
+
+bool hashmap_contains_hashed(HashMap *map, void *key, size_t hash) {
+    return hashmap_find(map, key, hash) != NULL;
+}
+
+// Returns the entry of key, adding it with a default value first when it is absent.
+// The entry stays valid until the next insert or remove on the map.
+void *hashmap_entry(HashMap *map, void *key, bool *inserted) {
+    hashmap_watchdog(map);
+    bool claimed;
+    unsigned char *node = hashmap_find_or_insert(map, key, hashmap_hash(map, key), &claimed, false);
+    if (node != NULL && claimed) {
+        if (HASHMAP_INLINE(map)) {
+            memset(node + map->value_offset, 0, map->value_size);
+        } else if (HASHMAP_HAS_VALUES(map)) {
+            ((HashMapNode *)node)->value = USE_CRT(map->value_methods);
         }
-        probe_count++;
-        index = hashmap_probe_next(map->capacity, index, probe_count);
     }
-    return false;
+    if (inserted != NULL) {
+        *inserted = claimed;
+    }
+    return node;
+}
+
+void *hashmap_entry_key(HashMap *map, void *entry) {
+    return HASHMAP_NODE_KEY(map, (unsigned char *)entry);
+}
+
+void *hashmap_entry_value(HashMap *map, void *entry) {
+    return HASHMAP_NODE_VALUE(map, (unsigned char *)entry);
 }
 
-// HashMapNode *hashmap_find(HashMap *map, void *key) {
-//     size_t index = USE_HASH(map->key_methods, key) % map->capacity;
-//     size_t probe_count = 0;
-//     while (map->nodes[index].status != HASHMAP_NODE_FREE) {
-//         if (map->nodes[index].status == HASHMAP_NODE_FILLED && USE_CMP(map->key_methods, map->nodes[index].key, key) == 0) {
-//             return map->nodes + index;
-//         }
-//         probe_count++;
-//         index = hashmap_probe_next(map, index, probe_count);
-//     }
-//     return NULL;
-// }
+// Replaces the value of an entry, releasing the previous one
+void hashmap_entry_set(HashMap *map, void *entry, void *value) {
+    unsigned char *node = entry;
+    if (!HASHMAP_HAS_VALUES(map)) {
+        return;
+    }
+    if (HASHMAP_INLINE(map)) {
+        memcpy(node + map->value_offset, value, map->value_size);
+        return;
+    }
+    USE_DEL(map->value_methods, ((HashMapNode *)node)->value);
+    ((HashMapNode *)node)->value = USE_DUP(map->value_methods, value);
+}
 
 void hashmap_rehash(HashMap *map, size_t new_capacity) {
-    // if (map->occupied_size == 0) {
-    //     map->capacity = new_capacity;
-    //     return;
-    // }
+    hashmap_migrate(map, SIZE_MAX);
+
+    // Never shrink below what the live entries need
+    size_t min_capacity = hashmap_capacity_for(map->size);
+    new_capacity = hashmap_round_capacity(new_capacity > min_capacity ? new_capacity : min_capacity);
+    if (map->dense) {
+        hashmap_dense_rebuild(map, new_capacity);
+        return;
+    }
+    if (new_capacity == map->capacity && map->probe == HASHMAP_PROBE_TRIANGULAR) {
+        hashmap_purge_tombstones(map);
+        return;
+    }
 
-    HashMapNode *new_nodes = calloc(new_capacity, sizeof(HashMapNode));
-    if (new_nodes == NULL) {
+    unsigned char *new_nodes = malloc(new_capacity * map->slot_size);
+    unsigned char *new_ctrl = hashmap_ctrl_create(new_capacity);
+    if (new_nodes == NULL || new_ctrl == NULL) {
+        free(new_nodes);
+        free(new_ctrl);
         return;
     }
 
-    size_t new_size = 0;
-    
+    unsigned char *old_nodes = map->nodes;
+    unsigned char *old_ctrl = map->ctrl;
+    size_t old_capacity = map->capacity;
+
+    map->nodes = new_nodes;
+    map->ctrl = new_ctrl;
+    map->capacity = new_capacity;
+    map->occupied_size = 0;
+
     #if DEBUG
     // printf("Old size %lu\n",  map->size);
     #endif
-    for (size_t i = 0; i < map->capacity; i++) {
-        if (map->nodes[i].status != HASHMAP_NODE_FILLED) {
+    for (size_t i = 0; i < old_capacity; i++) {
+        if (!HASHMAP_CTRL_FILLED(old_ctrl[i])) {
             continue;
         }
-        size_t index = USE_HASH(map->key_methods, map->nodes[i].key) % new_capacity;
-        size_t probe_count = 0;
-        while (new_nodes[index].status == HASHMAP_NODE_FILLED) {
-            probe_count++;
-            index = hashmap_probe_next(new_capacity, index, probe_count);
-        }
-        new_nodes[index].key = map->nodes[i].key;
-        new_nodes[index].value = map->nodes[i].value;
-        new_nodes[index].status = HASHMAP_NODE_FILLED;
-        new_size++;
+        unsigned char *node = HASHMAP_NODE_AT(map, old_nodes, i);
+        size_t index = hashmap_claim_index(map, HASHMAP_NODE_HASH(node));
+        memcpy(hashmap_node(map, index), node, map->slot_size);
     }
 
-    free(map->nodes);
-    map->capacity = new_capacity;
-    map->nodes = new_nodes;
-    map->occupied_size = new_size;
-    map->size = new_size;
+    free(old_nodes);
+    free(old_ctrl);
     #if DEBUG
     // printf("New size %lu\n",  map->size);
     // HASHMAP_PRINTF(map, char *key, void *value, "%s", key); printf("\n");
     #endif
-    
+
     return;
 }
 
@@ -202,99 +1040,291 @@ size_t hashmap_capacity(HashMap *map) {
     return map->capacity;
 }
 
-void hashmap_add(HashMap *map, void *key) {
-    if (hashmap_need_rehash(map, map->occupied_size + 1)) {
-        hashmap_rehash(map, map->capacity * 2);
+// budget is the number of slots, free or filled, of the previous table moved by each insert or remove,
+// 0 disables incremental resizing. It is a lower bound : when the insertions left before the next grow
+// would not get through the previous table at budget slots each, they move more. With the table doubling
+// at HASHMAP_LOAD_FACTOR 0.75 that is 2 slots per insertion. Dense maps compact their entries while resizing and ignore it.
+void hashmap_set_migration_budget(HashMap *map, size_t budget) {
+    map->migration_budget = map->dense ? 0 : budget;
+    if (budget == 0) {
+        hashmap_migrate(map, SIZE_MAX);
     }
+}
+
+bool hashmap_migrating(HashMap *map) {
+    return map->old_capacity != 0;
+}
 
-    size_t index = USE_HASH(map->key_methods, key) % map->capacity;
-    size_t probe_count = 0;
-    while (map->nodes[index].status != HASHMAP_NODE_FREE) {
-        if (map->nodes[index].status == HASHMAP_NODE_FILLED && USE_CMP(map->key_methods, map->nodes[index].key, key) == 0) {
-            return;  // Key already exists
+// Hashes every key again with seed and rebuilds the table at its current capacity. Maps are seeded
+// at random on creation, giving several maps the same seed lets them share precomputed hashes.
+void hashmap_reseed(HashMap *map, uint64_t seed) {
+    hashmap_migrate(map, SIZE_MAX);
+    map->seed = seed;
+    for (size_t i = 0; i < HASHMAP_ITER_COUNT(map); i++) {
+        if (HASHMAP_ITER_LIVE(map, i)) {
+            unsigned char *node = HASHMAP_ITER_NODE(map, i);
+            HASHMAP_NODE_HASH(node) = hashmap_hash(map, HASHMAP_NODE_KEY(map, node));
         }
-        probe_count++;
-        index = hashmap_probe_next(map->capacity, index, probe_count);
     }
+    hashmap_rehash(map, map->capacity);
+    map->reseed_capacity = map->capacity;
+    if (map->filter != NULL) {
+        hashmap_filter_rebuild(map, map->filter->false_positive_rate);
+    }
+}
 
-    if (map->nodes[index].status == HASHMAP_NODE_FREE) {
-        map->occupied_size++;
+// The watchdog reseeds a map whose insertions probe more than HASHMAP_PROBE_LIMIT groups.
+// Maps looked up with hashes computed elsewhere must turn it off, since reseeding invalidates them.
+void hashmap_set_watchdog(HashMap *map, bool enabled) {
+    map->watchdog = enabled;
+    map->reseed_pending = false;
+}
+
+// Puts a blocked Bloom filter of the cached hashes in front of every lookup, so that most absent
+// keys are turned away without probing or comparing. Misses usually stop at the first group already,
+// so it only pays off for long probe chains or costly comparators, while hits and inserts pay for
+// the filter on top. The filter is rebuilt as the map grows.
+void hashmap_attach_filter(HashMap *map, double false_positive_rate) {
+    hashmap_filter_rebuild(map, false_positive_rate);
+}
+
+void hashmap_detach_filter(HashMap *map) {
+    bloomfilter_destroy(map->filter);
+    map->filter = NULL;
+}
+
+// Makes room for size entries in total, so that inserting up to that many never grows the table
+void hashmap_reserve(HashMap *map, size_t size) {
+    size_t capacity = hashmap_capacity_for(size);
+    size_t tombstones = map->occupied_size - (map->size - map->old_size);
+    if (capacity > map->capacity || hashmap_need_rehash(map, size + tombstones)) {
+        hashmap_rehash(map, capacity > map->capacity ? capacity : map->capacity);
     }
-    map->nodes[index].key = USE_DUP(map->key_methods, key);
-    map->nodes[index].value = USE_CRT(map->value_methods);
-    map->nodes[index].status = HASHMAP_NODE_FILLED;
-    map->size++;
+    // Removed entries keep their room in the entries array until the next compaction
+    if (map->dense && size > map->size && map->entry_count + (size - map->size) > map->entry_capacity) {
+        hashmap_dense_resize_entries(map, map->entry_count + (size - map->size));
+    }
+}
+
+// Shrinks the table to the smallest capacity holding the current entries
+void hashmap_shrink_to_fit(HashMap *map) {
+    hashmap_shrink(map, hashmap_capacity_for(map->size));
+}
+
+// Once removals bring the load below load_factor, the table shrinks to fit, never below HASHMAP_INITIAL_CAPACITY.
+// load_factor must stay under half of HASHMAP_LOAD_FACTOR so a shrunk table is not shrunk again right away, 0 disables it.
+void hashmap_set_shrink_threshold(HashMap *map, double load_factor) {
+    assert(load_factor >= 0 && load_factor < HASHMAP_LOAD_FACTOR / 2);
+    map->shrink_load_factor = load_factor;
+}
+
+void hashmap_add(HashMap *map, void *key) {
+    hashmap_entry(map, key, NULL);
 }
 
 void hashmap_set(HashMap *map, void *key, void *value) {
-    if (hashmap_need_rehash(map, map->occupied_size + 1)) {
-        hashmap_rehash(map, map->capacity * 2);
-    }
+    hashmap_watchdog(map);
+    hashmap_set_hashed(map, key, hashmap_hash(map, key), value);
+}
 
-    size_t index = USE_HASH(map->key_methods, key) % map->capacity;
-    size_t probe_count = 0;
-    while (map->nodes[index].status != HASHMAP_NODE_FREE) {
-        if (map->nodes[index].status == HASHMAP_NODE_FILLED && USE_CMP(map->key_methods, map->nodes[index].key, key) == 0) {
-            USE_DEL(map->value_methods, map->nodes[index].value);
-            map->nodes[index].value = USE_DUP(map->value_methods, value);
-            return;
-        }
-        probe_count++;
-        index = hashmap_probe_next(map->capacity, index, probe_count);
+void hashmap_set_hashed(HashMap *map, void *key, size_t hash, void *value) {
+    bool inserted;
+    unsigned char *node = hashmap_find_or_insert(map, key, hash, &inserted, false);
+    if (node == NULL) {
+        return;
     }
-
-    if (map->nodes[index].status == HASHMAP_NODE_FREE) {
-        map->occupied_size++;
+    if (inserted && !HASHMAP_INLINE(map) && HASHMAP_HAS_VALUES(map)) {
+        ((HashMapNode *)node)->value = USE_DUP(map->value_methods, value);
+        return;
     }
+    hashmap_entry_set(map, node, value);
+}
 
-    void *duplicated_key = USE_DUP(map->key_methods, key);
-    // fprintf(stderr, "Duplicating key %p %p\n", key, duplicated_key);
-    map->nodes[index].key = duplicated_key;
-    // map->nodes[index].key = map->key_methods->dup(key);
-    map->nodes[index].value = USE_DUP(map->value_methods, value);
-    map->nodes[index].status = HASHMAP_NODE_FILLED;
-    map->size++;
-    return;
+// Stores key and value without copying them, the map destroys them later with the type methods.
+// When key is already present the map keeps its own key and destroys the one passed in. Key only maps ignore value.
+void hashmap_set_owned(HashMap *map, void *key, void *value) {
+    assert(!HASHMAP_INLINE(map));
+    hashmap_watchdog(map);
+    bool inserted;
+    HashMapNode *node = (HashMapNode *)hashmap_find_or_insert(map, key, hashmap_hash(map, key), &inserted, true);
+    if (node == NULL) {
+        USE_DEL(map->key_methods, key);
+        USE_DEL(map->value_methods, value);
+        return;
+    }
+    if (!inserted && node->key != key) {
+        USE_DEL(map->key_methods, key);
+    }
+    if (!HASHMAP_HAS_VALUES(map)) {
+        return;
+    }
+    if (!inserted && node->value != value) {
+        USE_DEL(map->value_methods, node->value);
+    }
+    node->value = value;
 }
 
 void hashmap_reset(HashMap *map, void *key) {
-    size_t index = USE_HASH(map->key_methods, key) % map->capacity;
-    size_t probe_count = 0;
-    while (map->nodes[index].status != HASHMAP_NODE_FREE) {
-        if (map->nodes[index].status == HASHMAP_NODE_FILLED && USE_CMP(map->key_methods, map->nodes[index].key, key) == 0) {
-            USE_DEL(map->value_methods, map->nodes[index].value);
-            map->nodes[index].value = USE_CRT(map->value_methods);
-            return;
-        }
-        probe_count++;
-        index = hashmap_probe_next(map->capacity, index, probe_count);
+    unsigned char *node = hashmap_find_entry(map, key, hashmap_hash(map, key));
+    if (node == NULL) {
+        return;
+    }
+    if (HASHMAP_INLINE(map) || !HASHMAP_HAS_VALUES(map)) {
+        memset(node + map->value_offset, 0, map->value_size);
+        return;
     }
+    USE_DEL(map->value_methods, ((HashMapNode *)node)->value);
+    ((HashMapNode *)node)->value = USE_CRT(map->value_methods);
 }
 
 void hashmap_remove(HashMap *map, void *key) {
-    size_t index = USE_HASH(map->key_methods, key) % map->capacity;
-    size_t probe_count = 0;
-    while (map->nodes[index].status != HASHMAP_NODE_FREE) {
-        if (map->nodes[index].status == HASHMAP_NODE_FILLED && USE_CMP(map->key_methods, map->nodes[index].key, key) == 0) {
-            USE_DEL(map->key_methods, map->nodes[index].key);
-            USE_DEL(map->value_methods, map->nodes[index].value);
-            map->nodes[index].status = HASHMAP_NODE_DELETED;
-            map->size--;
-            return;
+    hashmap_remove_hashed(map, key, hashmap_hash(map, key));
+}
+
+void hashmap_remove_hashed(HashMap *map, void *key, size_t hash) {
+    hashmap_remove_entry(map, key, hash, NULL, NULL);
+}
+
+// Removes key without destroying the stored key and value, they are handed to the caller through out_key and out_value.
+// Either may be NULL to destroy that half as hashmap_remove would. False when key is absent.
+bool hashmap_take(HashMap *map, void *key, void **out_key, void **out_value) {
+    assert(!HASHMAP_INLINE(map));
+    return hashmap_remove_entry(map, key, hashmap_hash(map, key), out_key, out_value);
+}
+
+static bool hashmap_remove_entry(HashMap *map, void *key, size_t hash, void **out_key, void **out_value) {
+    hashmap_migrate(map, hashmap_migration_step(map));
+    unsigned char *node = hashmap_find(map, key, hash);
+    if (node == NULL) {
+        return false;
+    }
+    unsigned char *entry = hashmap_slot_entry(map, node);
+    if (!HASHMAP_INLINE(map)) {
+        void *stored_value = HASHMAP_HAS_VALUES(map) ? ((HashMapNode *)entry)->value : NULL;
+        if (out_key != NULL) {
+            *out_key = ((HashMapNode *)entry)->key;
+        } else {
+            USE_DEL(map->key_methods, ((HashMapNode *)entry)->key);
+        }
+        if (out_value != NULL) {
+            *out_value = stored_value;
+        } else {
+            USE_DEL(map->value_methods, stored_value);
+        }
+    }
+    if (map->dense) {
+        map->entry_live[((HashMapIndex *)node)->entry] = false;
+    }
+    if (node >= map->nodes && node < map->nodes + map->capacity * map->slot_size) {
+        size_t index = (size_t)(node - map->nodes) / map->slot_size;
+        if (map->probe != HASHMAP_PROBE_TRIANGULAR) {
+            hashmap_backward_shift(map, index);
+        } else if (hashmap_was_never_full(map, index)) {
+            hashmap_set_ctrl(map, index, HASHMAP_CTRL_FREE);
+            map->occupied_size--;
+        } else {
+            hashmap_set_ctrl(map, index, HASHMAP_CTRL_DELETED);
         }
-        probe_count++;
-        index = hashmap_probe_next(map->capacity, index, probe_count);
+    } else {
+        // The previous table keeps its tombstones, it is dropped once migration finishes
+        size_t index = (size_t)(node - map->old_nodes) / map->slot_size;
+        hashmap_store_ctrl(map->old_ctrl, map->old_capacity, index, HASHMAP_CTRL_DELETED);
+        map->old_size--;
     }
+    map->size--;
+
+    // A migration in progress already rebuilds the table, it is left to finish
+    if (map->shrink_load_factor > 0 && map->old_capacity == 0 && map->capacity > HASHMAP_INITIAL_CAPACITY &&
+        (double)map->size / map->capacity < map->shrink_load_factor) {
+        size_t capacity = hashmap_capacity_for(map->size);
+        hashmap_shrink(map, capacity > HASHMAP_INITIAL_CAPACITY ? capacity : HASHMAP_INITIAL_CAPACITY);
+    }
+    return true;
 }
 
 void hashmap_clear(HashMap *map) {
-    for (size_t i = 0; i < map->capacity; i++) {
-        if (map->nodes[i].status == HASHMAP_NODE_FILLED) {
-            USE_DEL(map->key_methods, map->nodes[i].key);
-            USE_DEL(map->value_methods, map->nodes[i].value);
-            map->nodes[i].status = HASHMAP_NODE_FREE;
-        }
+    if (!HASHMAP_INLINE(map)) {
+        HASHMAP_PAIRS_FOREACH(map, void *key, void *value, {
+            USE_DEL(map->key_methods, key);
+            USE_DEL(map->value_methods, value);
+        });
     }
+    free(map->old_nodes);
+    free(map->old_ctrl);
+    map->old_nodes = NULL;
+    map->old_ctrl = NULL;
+    map->old_capacity = 0;
+    map->old_size = 0;
+    memset(map->ctrl, HASHMAP_CTRL_FREE, map->capacity + HASHMAP_GROUP_WIDTH);
     map->size = 0;
     map->occupied_size = 0;
-}
\ No newline at end of file
+    map->entry_count = 0;
+    if (map->filter != NULL) {
+        bloomfilter_clear(map->filter);
+    }
+}
+
+// Copies the tables as they are, control bytes included, so no key is hashed or probed again.
+// Like vector_clone, new_data_methods become the value methods of the clone while the values are
+// duplicated with those of map. Inline maps and keys and values without a dup method are copied bytewise.
+HashMap *hashmap_clone(HashMap *map, type_methods *new_data_methods) {
+    HashMap *clone = hashmap_create_layout(map->key_methods, new_data_methods, map->probe, map->key_size, map->value_size, map->dense, map->capacity);
+    if (clone == NULL) {
+        return NULL;
+    }
+    unsigned char *old_nodes = NULL;
+    unsigned char *old_ctrl = NULL;
+    if (map->old_capacity != 0) {
+        old_nodes = malloc(map->old_capacity * map->slot_size);
+        old_ctrl = malloc(map->old_capacity + HASHMAP_GROUP_WIDTH);
+    }
+    if ((map->old_capacity != 0 && (old_nodes == NULL || old_ctrl == NULL)) ||
+        (map->dense && !hashmap_dense_resize_entries(clone, map->entry_capacity))) {
+        free(old_nodes);
+        free(old_ctrl);
+        hashmap_destroy(clone);
+        return NULL;
+    }
+
+    memcpy(clone->nodes, map->nodes, map->capacity * map->slot_size);
+    memcpy(clone->ctrl, map->ctrl, map->capacity + HASHMAP_GROUP_WIDTH);
+    if (map->old_capacity != 0) {
+        memcpy(old_nodes, map->old_nodes, map->old_capacity * map->slot_size);
+        memcpy(old_ctrl, map->old_ctrl, map->old_capacity + HASHMAP_GROUP_WIDTH);
+    }
+    clone->old_nodes = old_nodes;
+    clone->old_ctrl = old_ctrl;
+    clone->old_capacity = map->old_capacity;
+    clone->old_size = map->old_size;
+    clone->migrate_index = map->migrate_index;
+    clone->migration_budget = map->migration_budget;
+    clone->shrink_load_factor = map->shrink_load_factor;
+    clone->seed = map->seed;
+    clone->watchdog = map->watchdog;
+    clone->reseed_pending = map->reseed_pending;
+    clone->reseed_capacity = map->reseed_capacity;
+    clone->filter = map->filter != NULL ? bloomfilter_clone(map->filter) : NULL;
+    clone->occupied_size = map->occupied_size;
+    clone->size = map->size;
+    if (map->dense) {
+        memcpy(clone->entries, map->entries, map->entry_count * map->entry_size);
+        memcpy(clone->entry_live, map->entry_live, map->entry_count * sizeof(bool));
+        clone->entry_count = map->entry_count;
+    }
+
+    bool dup_keys = map->key_methods != NULL && map->key_methods->dup != NULL;
+    bool dup_values = map->value_methods != NULL && map->value_methods->dup != NULL;
+    if (HASHMAP_INLINE(map) || (!dup_keys && !dup_values)) {
+        return clone;
+    }
+    for (size_t i = 0; i < HASHMAP_ITER_COUNT(clone); i++) {
+        if (HASHMAP_ITER_LIVE(clone, i)) {
+            HashMapNode *node = (HashMapNode *)HASHMAP_ITER_NODE(clone, i);
+            node->key = USE_DUP(map->key_methods, node->key);
+            if (HASHMAP_HAS_VALUES(map)) {
+                node->value = USE_DUP(map->value_methods, node->value);
+            }
+        }
+    }
+    return clone;
+}
@@ -0,0 +1,168 @@
+#include "hashset.h"
+
+#include <stdbool.h>
+#include <stdlib.h>
+
+#include "hashmap.h"
+
+// ==== Method Overview ====
+
+// Private Methods :
+
+static HashSet *hashset_wrap(HashMap *map, type_methods *data_methods);
+
+// Constructors and destructors :
+
+HashSet *hashset_create(type_methods *data_methods);
+void hashset_destroy(HashSet *set);
+
+// Access and iteration :
+
+bool hashset_contains(HashSet *set, void *data);
+void *hashset_get_key(HashSet *set, void *data);
+
+// Capacity :
+
+bool hashset_empty(HashSet *set);
+size_t hashset_size(HashSet *set);
+void hashset_reserve(HashSet *set, size_t size);
+
+// Modifiers :
+
+void hashset_add(HashSet *set, void *data);
+void hashset_remove(HashSet *set, void *data);
+void hashset_clear(HashSet *set);
+
+// Copy constructors and creators :
+
+HashSet *hashset_clone(HashSet *set);
+HashSet *hashset_union(HashSet *first, HashSet *second);
+HashSet *hashset_intersection(HashSet *first, HashSet *second);
+HashSet *hashset_difference(HashSet *first, HashSet *second);
+
+// ==== End of Method Overview ====
+
+// Private methods
+
+// Takes ownership of map, destroying it if the set cannot be allocated
+static HashSet *hashset_wrap(HashMap *map, type_methods *data_methods) {
+    if (map == NULL) {
+        return NULL;
+    }
+    HashSet *set = malloc(sizeof(HashSet));
+    if (set == NULL) {
+        hashmap_destroy(map);
+        return NULL;
+    }
+    set->map = map;
+    set->data_methods = data_methods;
+    return set;
+}
+
+// End of private methods
+
+HashSet *hashset_create(type_methods *data_methods) {
+    return hashset_wrap(hashmap_create_keys(data_methods), data_methods);
+}
+
+void hashset_destroy(HashSet *set) {
+    if (set == NULL) {
+        return;
+    }
+    hashmap_destroy(set->map);
+    free(set);
+}
+
+bool hashset_contains(HashSet *set, void *data) {
+    return hashmap_contains(set->map, data);
+}
+
+void *hashset_get_key(HashSet *set, void *data) {
+    return hashmap_get_key(set->map, data);
+}
+
+bool hashset_empty(HashSet *set) {
+    return hashmap_empty(set->map);
+}
+
+size_t hashset_size(HashSet *set) {
+    return hashmap_size(set->map);
+}
+
+void hashset_reserve(HashSet *set, size_t size) {
+    hashmap_reserve(set->map, size);
+}
+
+void hashset_add(HashSet *set, void *data) {
+    hashmap_add(set->map, data);
+}
+
+void hashset_remove(HashSet *set, void *data) {
+    hashmap_remove(set->map, data);
+}
+
+void hashset_clear(HashSet *set) {
+    hashmap_clear(set->map);
+}
+
+HashSet *hashset_clone(HashSet *set) {
+    return hashset_wrap(hashmap_clone(set->map, NULL), set->data_methods);
+}
+
+// The set algebra below expects both sets to share their data methods, the result uses those of first.
+// Each one copies or probes the larger operand as a whole and only iterates the smaller one.
+
+HashSet *hashset_union(HashSet *first, HashSet *second) {
+    HashSet *larger = hashset_size(first) >= hashset_size(second) ? first : second;
+    HashSet *smaller = larger == first ? second : first;
+    HashSet *result = hashset_wrap(hashmap_clone(larger->map, NULL), first->data_methods);
+    if (result == NULL) {
+        return NULL;
+    }
+    hashset_reserve(result, hashset_size(larger) + hashset_size(smaller));
+    HASHSET_FOREACH(smaller, void *data, {
+        hashset_add(result, data);
+    });
+    return result;
+}
+
+HashSet *hashset_intersection(HashSet *first, HashSet *second) {
+    HashSet *larger = hashset_size(first) >= hashset_size(second) ? first : second;
+    HashSet *smaller = larger == first ? second : first;
+    HashSet *result = hashset_create(first->data_methods);
+    if (result == NULL) {
+        return NULL;
+    }
+    hashset_reserve(result, hashset_size(smaller));
+    HASHSET_FOREACH(smaller, void *data, {
+        if (hashset_contains(larger, data)) {
+            hashset_add(result, data);
+        }
+    });
+    return result;
+}
+
+// Elements of first missing from second
+HashSet *hashset_difference(HashSet *first, HashSet *second) {
+    if (hashset_size(first) <= hashset_size(second)) {
+        HashSet *result = hashset_create(first->data_methods);
+        if (result == NULL) {
+            return NULL;
+        }
+        hashset_reserve(result, hashset_size(first));
+        HASHSET_FOREACH(first, void *data, {
+            if (!hashset_contains(second, data)) {
+                hashset_add(result, data);
+            }
+        });
+        return result;
+    }
+    HashSet *result = hashset_clone(first);
+    if (result == NULL) {
+        return NULL;
+    }
+    HASHSET_FOREACH(second, void *data, {
+        hashset_remove(result, data);
+    });
+    return result;
+}
@@ -0,0 +1,90 @@
+#include "interner.h"
+
+#include <assert.h>
+#include <stdlib.h>
+#include <string.h>
+
+static type_methods TYPE_STRING = TYPE_METHODS_SEEDED(string);
+static type_methods TYPE_SYMBOL = TYPE_METHODS(uint32_t);
+
+Interner *interner_create() {
+    Interner *interner = malloc(sizeof(Interner));
+    if (interner == NULL) {
+        return NULL;
+    }
+    interner->symbols = hashmap_create(&TYPE_STRING, &TYPE_SYMBOL);
+    interner->strings = vector_create(NULL);
+    if (interner->symbols == NULL || interner->strings == NULL) {
+        hashmap_destroy(interner->symbols);
+        if (interner->strings != NULL) {
+            vector_destroy(interner->strings);
+        }
+        free(interner);
+        return NULL;
+    }
+    return interner;
+}
+
+void interner_destroy(Interner *interner) {
+    if (interner == NULL) return;
+    vector_destroy(interner->strings);
+    hashmap_destroy(interner->symbols);
+    free(interner);
+}
+
+char *interner_find(Interner *interner, const char *str) {
+    return hashmap_get_key(interner->symbols, (void *)str);
+}
+
+char *interner_string(Interner *interner, uint32_t symbol) {
+    return symbol < vector_size(interner->strings) ? vector_get(interner->strings, symbol) : NULL;
+}
+
+size_t interner_size(Interner *interner) {
+    return vector_size(interner->strings);
+}
+
+// Entry of str, numbering and recording it when it is new
+static void *interner_entry(Interner *interner, const char *str) {
+    bool inserted;
+    void *entry = hashmap_entry(interner->symbols, (void *)str, &inserted);
+    if (inserted) {
+        assert(vector_size(interner->strings) < UINT32_MAX);
+        *(uint32_t *)hashmap_entry_value(interner->symbols, entry) = (uint32_t)vector_size(interner->strings);
+        vector_push_back(interner->strings, hashmap_entry_key(interner->symbols, entry));
+    }
+    return entry;
+}
+
+char *interner_intern(Interner *interner, const char *str) {
+    return hashmap_entry_key(interner->symbols, interner_entry(interner, str));
+}
+
+uint32_t interner_symbol(Interner *interner, const char *str) {
+    return *(uint32_t *)hashmap_entry_value(interner->symbols, interner_entry(interner, str));
+}
+
+void *interned_default_constructor() {
+    return NULL;
+}
+
+void interned_destructor(void *ptr) {
+    (void)ptr;
+}
+
+void *interned_copy_constructor(void *ptr) {
+    return ptr;
+}
+
+int interned_comparator(void *first, void *second) {
+    return (first > second) - (first < second);
+}
+
+// The pointer value is the key, not the characters it points at
+size_t interned_hash_function(void *ptr) {
+    return numerical_hash_inline(sizeof(void *), &ptr);
+}
+
+size_t interned_seeded_hash_function(void *ptr, uint64_t seed) {
+    return numerical_seeded_hash_function(sizeof(void *), &ptr, seed);
+}
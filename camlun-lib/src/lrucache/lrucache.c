@@ -0,0 +1,297 @@
+#include "lrucache.h"
+
+#include <assert.h>
+#include <stdbool.h>
+#include <stdlib.h>
+
+#include "hashmap.h"
+
+// ==== Method Overview ====
+
+// Private Methods :
+
+static LruCache *lrucache_create_policy(type_methods *key_methods, type_methods *value_methods, size_t capacity, lrucache_policy policy);
+static void lrucache_unlink(LruCache *cache, uint32_t index);
+static void lrucache_push_front(LruCache *cache, uint32_t index);
+static uint32_t lrucache_victim(LruCache *cache);
+static void lrucache_release(LruCache *cache, uint32_t index, bool evicted);
+
+// Constructors and destructors :
+
+LruCache *lrucache_create(type_methods *key_methods, type_methods *value_methods, size_t capacity);
+LruCache *lrucache_create_clock(type_methods *key_methods, type_methods *value_methods, size_t capacity);
+void lrucache_destroy(LruCache *cache);
+
+// Access :
+
+void *lrucache_get(LruCache *cache, void *key);
+void *lrucache_peek(LruCache *cache, void *key);
+bool lrucache_contains(LruCache *cache, void *key);
+
+// Capacity and statistics :
+
+size_t lrucache_size(LruCache *cache);
+size_t lrucache_capacity(LruCache *cache);
+size_t lrucache_hits(LruCache *cache);
+size_t lrucache_misses(LruCache *cache);
+size_t lrucache_evictions(LruCache *cache);
+void lrucache_reset_stats(LruCache *cache);
+
+// Modifiers :
+
+void lrucache_put(LruCache *cache, void *key, void *value);
+void lrucache_remove(LruCache *cache, void *key);
+void lrucache_clear(LruCache *cache);
+void lrucache_set_evict_callback(LruCache *cache, lrucache_evict_callback callback, void *context);
+
+// ==== End of Method Overview ====
+
+// Private methods
+
+static LruCache *lrucache_create_policy(type_methods *key_methods, type_methods *value_methods, size_t capacity, lrucache_policy policy) {
+    assert(capacity > 0 && capacity < LRUCACHE_NONE);
+    LruCache *cache = malloc(sizeof(LruCache));
+    if (cache == NULL) {
+        return NULL;
+    }
+    cache->nodes = malloc(capacity * sizeof(LruCacheNode));
+    // The map stores node pointers as is, the nodes own the values
+    cache->map = hashmap_create_with_capacity(key_methods, NULL, capacity);
+    if (cache->nodes == NULL || cache->map == NULL) {
+        free(cache->nodes);
+        hashmap_destroy(cache->map);
+        free(cache);
+        return NULL;
+    }
+    cache->key_methods = key_methods;
+    cache->value_methods = value_methods;
+    cache->capacity = capacity;
+    cache->policy = policy;
+    cache->on_evict = NULL;
+    cache->evict_context = NULL;
+    cache->size = 0;
+    lrucache_clear(cache);
+    lrucache_reset_stats(cache);
+    return cache;
+}
+
+static void lrucache_unlink(LruCache *cache, uint32_t index) {
+    LruCacheNode *node = &cache->nodes[index];
+    if (node->prev != LRUCACHE_NONE) {
+        cache->nodes[node->prev].next = node->next;
+    } else {
+        cache->head = node->next;
+    }
+    if (node->next != LRUCACHE_NONE) {
+        cache->nodes[node->next].prev = node->prev;
+    } else {
+        cache->tail = node->prev;
+    }
+}
+
+static void lrucache_push_front(LruCache *cache, uint32_t index) {
+    LruCacheNode *node = &cache->nodes[index];
+    node->prev = LRUCACHE_NONE;
+    node->next = cache->head;
+    if (cache->head != LRUCACHE_NONE) {
+        cache->nodes[cache->head].prev = index;
+    } else {
+        cache->tail = index;
+    }
+    cache->head = index;
+}
+
+// Entry to evict from a full cache. The clock clears the bits it passes,
+// so it stops within two turns even when every entry was referenced.
+static uint32_t lrucache_victim(LruCache *cache) {
+    if (cache->policy == LRUCACHE_LRU) {
+        return cache->tail;
+    }
+    while (1) {
+        uint32_t index = cache->hand;
+        cache->hand = (uint32_t)((cache->hand + 1) % cache->capacity);
+        LruCacheNode *node = &cache->nodes[index];
+        if (!node->used) {
+            continue;
+        }
+        if (!node->referenced) {
+            return index;
+        }
+        node->referenced = false;
+    }
+}
+
+// Destroys the entry of a node and returns the node to the free list
+static void lrucache_release(LruCache *cache, uint32_t index, bool evicted) {
+    LruCacheNode *node = &cache->nodes[index];
+    if (evicted) {
+        if (cache->on_evict != NULL) {
+            cache->on_evict(node->key, node->value, cache->evict_context);
+        }
+        cache->evictions++;
+    }
+    if (cache->policy == LRUCACHE_LRU) {
+        lrucache_unlink(cache, index);
+    }
+    USE_DEL(cache->value_methods, node->value);
+    hashmap_remove(cache->map, node->key);
+    node->used = false;
+    node->key = NULL;
+    node->value = NULL;
+    node->next = cache->free;
+    cache->free = index;
+    cache->size--;
+}
+
+// Constructors and destructors
+
+LruCache *lrucache_create(type_methods *key_methods, type_methods *value_methods, size_t capacity) {
+    return lrucache_create_policy(key_methods, value_methods, capacity, LRUCACHE_LRU);
+}
+
+LruCache *lrucache_create_clock(type_methods *key_methods, type_methods *value_methods, size_t capacity) {
+    return lrucache_create_policy(key_methods, value_methods, capacity, LRUCACHE_CLOCK);
+}
+
+void lrucache_destroy(LruCache *cache) {
+    if (cache == NULL) {
+        return;
+    }
+    lrucache_clear(cache);
+    hashmap_destroy(cache->map);
+    free(cache->nodes);
+    free(cache);
+}
+
+// Access
+
+// Counts a hit or a miss and marks the entry as recently used
+void *lrucache_get(LruCache *cache, void *key) {
+    LruCacheNode *node = hashmap_get(cache->map, key);
+    if (node == NULL) {
+        cache->misses++;
+        return NULL;
+    }
+    cache->hits++;
+    if (cache->policy == LRUCACHE_LRU) {
+        uint32_t index = (uint32_t)(node - cache->nodes);
+        if (cache->head != index) {
+            lrucache_unlink(cache, index);
+            lrucache_push_front(cache, index);
+        }
+    } else {
+        node->referenced = true;
+    }
+    return node->value;
+}
+
+// Looks the entry up without touching its recency or the counters
+void *lrucache_peek(LruCache *cache, void *key) {
+    LruCacheNode *node = hashmap_get(cache->map, key);
+    return node != NULL ? node->value : NULL;
+}
+
+bool lrucache_contains(LruCache *cache, void *key) {
+    return hashmap_contains(cache->map, key);
+}
+
+// Capacity and statistics
+
+size_t lrucache_size(LruCache *cache) {
+    return cache->size;
+}
+
+size_t lrucache_capacity(LruCache *cache) {
+    return cache->capacity;
+}
+
+size_t lrucache_hits(LruCache *cache) {
+    return cache->hits;
+}
+
+size_t lrucache_misses(LruCache *cache) {
+    return cache->misses;
+}
+
+size_t lrucache_evictions(LruCache *cache) {
+    return cache->evictions;
+}
+
+void lrucache_reset_stats(LruCache *cache) {
+    cache->hits = 0;
+    cache->misses = 0;
+    cache->evictions = 0;
+}
+
+// Modifiers
+
+// Replaces the value of a present key, otherwise inserts it, evicting an entry when full.
+// A put counts as a use of the entry.
+void lrucache_put(LruCache *cache, void *key, void *value) {
+    LruCacheNode *node = hashmap_get(cache->map, key);
+    if (node != NULL) {
+        USE_DEL(cache->value_methods, node->value);
+        node->value = USE_DUP(cache->value_methods, value);
+        uint32_t index = (uint32_t)(node - cache->nodes);
+        if (cache->policy == LRUCACHE_LRU) {
+            lrucache_unlink(cache, index);
+            lrucache_push_front(cache, index);
+        } else {
+            node->referenced = true;
+        }
+        return;
+    }
+    if (cache->size == cache->capacity) {
+        lrucache_release(cache, lrucache_victim(cache), true);
+    }
+
+    uint32_t index = cache->free;
+    node = &cache->nodes[index];
+    cache->free = node->next;
+    cache->size++;
+
+    bool inserted;
+    void *entry = hashmap_entry(cache->map, key, &inserted);
+    hashmap_entry_set(cache->map, entry, node);
+    node->key = hashmap_entry_key(cache->map, entry);
+    node->value = USE_DUP(cache->value_methods, value);
+    node->used = true;
+    node->referenced = false;
+    if (cache->policy == LRUCACHE_LRU) {
+        lrucache_push_front(cache, index);
+    }
+}
+
+// Removes the entry without calling the eviction callback
+void lrucache_remove(LruCache *cache, void *key) {
+    LruCacheNode *node = hashmap_get(cache->map, key);
+    if (node != NULL) {
+        lrucache_release(cache, (uint32_t)(node - cache->nodes), false);
+    }
+}
+
+// Destroys every entry without calling the eviction callback, the counters are kept
+void lrucache_clear(LruCache *cache) {
+    for (size_t i = 0; i < cache->capacity && cache->size > 0; i++) {
+        if (cache->nodes[i].used) {
+            USE_DEL(cache->value_methods, cache->nodes[i].value);
+            cache->size--;
+        }
+    }
+    hashmap_clear(cache->map);
+    for (size_t i = 0; i < cache->capacity; i++) {
+        cache->nodes[i] = (LruCacheNode){.key = NULL, .value = NULL, .prev = LRUCACHE_NONE,
+                                         .next = i + 1 < cache->capacity ? (uint32_t)(i + 1) : LRUCACHE_NONE,
+                                         .used = false, .referenced = false};
+    }
+    cache->size = 0;
+    cache->head = LRUCACHE_NONE;
+    cache->tail = LRUCACHE_NONE;
+    cache->hand = 0;
+    cache->free = 0;
+}
+
+void lrucache_set_evict_callback(LruCache *cache, lrucache_evict_callback callback, void *context) {
+    cache->on_evict = callback;
+    cache->evict_context = context;
+}
@@ -0,0 +1,65 @@
+#include "siphash.h"
+
+#include <string.h>
+
+#define SIPHASH_ROTL(x, b) (uint64_t)(((x) << (b)) | ((x) >> (64 - (b))))
+
+#define SIPHASH_ROUND(v0, v1, v2, v3) \
+    do {                              \
+        v0 += v1;                     \
+        v1 = SIPHASH_ROTL(v1, 13);    \
+        v1 ^= v0;                     \
+        v0 = SIPHASH_ROTL(v0, 32);    \
+        v2 += v3;                     \
+        v3 = SIPHASH_ROTL(v3, 16);    \
+        v3 ^= v2;                     \
+        v0 += v3;                     \
+        v3 = SIPHASH_ROTL(v3, 21);    \
+        v3 ^= v0;                     \
+        v2 += v1;                     \
+        v1 = SIPHASH_ROTL(v1, 17);    \
+        v1 ^= v2;                     \
+        v2 = SIPHASH_ROTL(v2, 32);    \
+    } while (0)
+
+// Little endian load whatever the host byte order
+static uint64_t siphash_load(const unsigned char *bytes, size_t count) {
+    uint64_t word = 0;
+    for (size_t i = 0; i < count; i++) {
+        word |= (uint64_t)bytes[i] << (8 * i);
+    }
+    return word;
+}
+
+uint64_t siphash13(const void *data, size_t len, uint64_t k0, uint64_t k1) {
+    const unsigned char *bytes = data;
+    uint64_t v0 = k0 ^ 0x736f6d6570736575ULL;
+    uint64_t v1 = k1 ^ 0x646f72616e646f6dULL;
+    uint64_t v2 = k0 ^ 0x6c7967656e657261ULL;
+    uint64_t v3 = k1 ^ 0x7465646279746573ULL;
+
+    size_t tail = len & 7;
+    const unsigned char *end = bytes + (len - tail);
+    for (; bytes != end; bytes += 8) {
+        uint64_t m;
+        #if __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+        memcpy(&m, bytes, sizeof(m));
+        #else
+        m = siphash_load(bytes, 8);
+        #endif
+        v3 ^= m;
+        SIPHASH_ROUND(v0, v1, v2, v3);
+        v0 ^= m;
+    }
+
+    uint64_t b = ((uint64_t)len << 56) | siphash_load(bytes, tail);
+    v3 ^= b;
+    SIPHASH_ROUND(v0, v1, v2, v3);
+    v0 ^= b;
+
+    v2 ^= 0xff;
+    SIPHASH_ROUND(v0, v1, v2, v3);
+    SIPHASH_ROUND(v0, v1, v2, v3);
+    SIPHASH_ROUND(v0, v1, v2, v3);
+    return v0 ^ v1 ^ v2 ^ v3;
+}
@@ -0,0 +1,137 @@
+#include "sstring.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+static char *sstring_mutable_data(SString *sstring) {
+    return sstring->length <= SSTRING_INLINE_CAPACITY ? sstring->inline_data : sstring->heap_data;
+}
+
+// Fills the header and the characters, the long buffer is either copied or borrowed from str
+static bool sstring_init(SString *sstring, const char *str, size_t length, bool copy) {
+    sstring->length = length;
+    sstring->hash = numerical_hash_function(length, (void *)str);
+    if (length <= SSTRING_INLINE_CAPACITY) {
+        memcpy(sstring->inline_data, str, length);
+        sstring->inline_data[length] = '\0';
+        return true;
+    }
+    if (!copy) {
+        sstring->heap_data = (char *)str;
+        return true;
+    }
+    sstring->heap_data = malloc(length + 1);
+    if (sstring->heap_data == NULL) {
+        return false;
+    }
+    memcpy(sstring->heap_data, str, length);
+    sstring->heap_data[length] = '\0';
+    return true;
+}
+
+SString *sstring_create(const char *str) {
+    return sstring_create_length(str, strlen(str));
+}
+
+SString *sstring_create_length(const char *str, size_t length) {
+    SString *sstring = malloc(sizeof(SString));
+    if (sstring == NULL) {
+        return NULL;
+    }
+    if (!sstring_init(sstring, str, length, true)) {
+        free(sstring);
+        return NULL;
+    }
+    return sstring;
+}
+
+SString sstring_borrow(const char *str) {
+    SString sstring;
+    sstring_init(&sstring, str, strlen(str), false);
+    return sstring;
+}
+
+const char *sstring_data(const SString *sstring) {
+    return sstring_mutable_data((SString *)sstring);
+}
+
+size_t sstring_length(const SString *sstring) {
+    return sstring->length;
+}
+
+bool sstring_equals(const SString *first, const SString *second) {
+    return first->hash == second->hash && first->length == second->length &&
+           memcmp(sstring_data(first), sstring_data(second), first->length) == 0;
+}
+
+void *sstring_default_constructor() {
+    return sstring_create_length("", 0);
+}
+
+void sstring_destructor(void *ptr) {
+    SString *sstring = ptr;
+    if (!sstring) return;
+    if (sstring->length > SSTRING_INLINE_CAPACITY) {
+        free(sstring->heap_data);
+    }
+    free(sstring);
+}
+
+void *sstring_copy_constructor(void *ptr) {
+    if (!ptr) return NULL;
+    SString *source = ptr;
+    SString *sstring = malloc(sizeof(SString));
+    if (sstring == NULL) {
+        return NULL;
+    }
+    // The hash is carried over, only long strings need a second allocation
+    memcpy(sstring, source, sizeof(SString));
+    if (source->length > SSTRING_INLINE_CAPACITY) {
+        sstring->heap_data = malloc(source->length + 1);
+        if (sstring->heap_data == NULL) {
+            free(sstring);
+            return NULL;
+        }
+        memcpy(sstring->heap_data, source->heap_data, source->length + 1);
+    }
+    return sstring;
+}
+
+int sstring_comparator(void *first, void *second) {
+    if (!first && !second) return 0;
+    if (!first) return -1;
+    if (!second) return 1;
+    SString *sstring1 = (SString *)first;
+    SString *sstring2 = (SString *)second;
+    if (sstring1->length != sstring2->length) {
+        return (sstring1->length > sstring2->length) - (sstring1->length < sstring2->length);
+    }
+    if (sstring1->hash != sstring2->hash) {
+        return (sstring1->hash > sstring2->hash) - (sstring1->hash < sstring2->hash);
+    }
+    int cmp = memcmp(sstring_data(sstring1), sstring_data(sstring2), sstring1->length);
+    return (cmp > 0) - (cmp < 0);
+}
+
+int sstring_lexical_comparator(void *first, void *second) {
+    if (!first && !second) return 0;
+    if (!first) return -1;
+    if (!second) return 1;
+    SString *sstring1 = (SString *)first;
+    SString *sstring2 = (SString *)second;
+    size_t common = sstring1->length < sstring2->length ? sstring1->length : sstring2->length;
+    int cmp = memcmp(sstring_data(sstring1), sstring_data(sstring2), common);
+    if (cmp != 0) {
+        return (cmp > 0) - (cmp < 0);
+    }
+    return (sstring1->length > sstring2->length) - (sstring1->length < sstring2->length);
+}
+
+size_t sstring_hash_function(void *ptr) {
+    return ((SString *)ptr)->hash;
+}
+
+size_t sstring_seeded_hash_function(void *ptr, uint64_t seed) {
+    SString *sstring = ptr;
+    return numerical_seeded_hash_function(sstring->length, (void *)sstring_data(sstring), seed);
+}
@@ -6,6 +6,8 @@
 
 // TreeSetNode Methods, should be private
 
+void treeset_filter_rebuild(TreeSet *set, double false_positive_rate);
+
 TreeSetNode *treesetnode_create(void *data, color color) {
     TreeSetNode *node = malloc(sizeof(TreeSetNode));
     if (node == NULL) {
@@ -122,11 +124,13 @@ TreeSetNode *treesetnode_get_max(TreeSetNode *node) {
     return node;
 }
 
-TreeSetNode *treeset_delete_helper(TreeSet *set, TreeSetNode *node, void *data, bool *balanced) {
+// Unlinks the node holding data and hands its stored pointer out through removed, left untouched when data is absent
+TreeSetNode *treeset_delete_helper(TreeSet *set, TreeSetNode *node, void *data, bool *balanced, void **removed) {
     if (node == NULL) {
         *balanced = true;
         return NULL;
     }
+    void *matched = NULL;
     if (USE_CMP(set->data_methods, node->data,  data) == 0) {
         if (node->child[LEFT] == NULL || node->child[RIGHT] == NULL) {
             TreeSetNode *temp = NULL;
@@ -147,32 +151,47 @@ TreeSetNode *treeset_delete_helper(TreeSet *set, TreeSetNode *node, void *data,
             #if DEBUG
             fprintf(stderr, "Deleting node %p\n", node->data);
             #endif
-            USE_DEL(set->data_methods, node->data);
+            *removed = node->data;
             treesetnode_destroy(node);
             return temp;
         } else {
+            // The predecessor moves up into this node, its own node is then unlinked below
             TreeSetNode *temp = treesetnode_get_max(node->child[LEFT]);
-            node->data = USE_DUP(set->data_methods, temp->data);
+            matched = node->data;
+            node->data = temp->data;
             data = temp->data;
         }
     }
     bool dir = USE_CMP(set->data_methods, data,  node->data) > 0;
-    node->child[dir] = treeset_delete_helper(set, node->child[dir], data, balanced);
+    node->child[dir] = treeset_delete_helper(set, node->child[dir], data, balanced, removed);
+    if (matched != NULL) {
+        *removed = matched;
+    }
     return *balanced ? node : treesetnode_delete_fix_up(node, dir, balanced);
 }
 
+// Links data in as is, the set owns it from then on
 void treeset_insert(TreeSet *set, void *data) {
-    void *new_data = USE_DUP(set->data_methods, data);
-    set->root = treeset_insert_helper(set, set->root, new_data);
+    set->root = treeset_insert_helper(set, set->root, data);
     set->root->color = BLACK;
+    set->size++;
+    if (set->filter != NULL) {
+        bloomfilter_add(set->filter, data);
+        if (bloomfilter_size(set->filter) > bloomfilter_capacity(set->filter)) {
+            treeset_filter_rebuild(set, set->filter->false_positive_rate);
+        }
+    }
 }
 
-void treeset_delete(TreeSet *set, void *data) {
+// Returns the stored pointer equal to data after unlinking it, NULL when absent
+void *treeset_delete(TreeSet *set, void *data) {
     bool balanced = false;
-    set->root = treeset_delete_helper(set, set->root, data, &balanced);
+    void *removed = NULL;
+    set->root = treeset_delete_helper(set, set->root, data, &balanced, &removed);
     if(set->root != NULL) {
         set->root->color = BLACK;
     }
+    return removed;
 }
 
 void treeset_destroy_helper(TreeSet *set, TreeSetNode *node) {
@@ -190,6 +209,19 @@ void treeset_destroy_helper(TreeSet *set, TreeSetNode *node) {
     return;
 }
 
+// Replaces the filter with one sized for twice the elements, holding all of them
+void treeset_filter_rebuild(TreeSet *set, double false_positive_rate) {
+    BloomFilter *filter = bloomfilter_create(set->data_methods, set->size > 32 ? 2 * set->size : 64, false_positive_rate);
+    bloomfilter_destroy(set->filter);
+    set->filter = filter;
+    if (filter == NULL) {
+        return;
+    }
+    TREESET_FOREACH(set, void *data, {
+        bloomfilter_add(filter, data);
+    });
+}
+
 // end of private
 
 TreeSet *treeset_create(type_methods *data_methods) {
@@ -200,6 +232,7 @@ TreeSet *treeset_create(type_methods *data_methods) {
     set->size = 0;
     set->data_methods = data_methods;
     set->root = NULL;
+    set->filter = NULL;
     return set;
 }
 
@@ -210,10 +243,22 @@ void treeset_destroy(TreeSet *this) {
     if(this->root != NULL) {
         treeset_destroy_helper(this, this->root);
     }
+    bloomfilter_destroy(this->filter);
     free(this);
     return;
 }
 
+// Checks the hash of the data against a blocked Bloom filter before every lookup, the data methods
+// must provide a hash consistent with the comparator. Removed elements stay in the filter until it is rebuilt.
+void treeset_attach_filter(TreeSet *this, double false_positive_rate) {
+    treeset_filter_rebuild(this, false_positive_rate);
+}
+
+void treeset_detach_filter(TreeSet *this) {
+    bloomfilter_destroy(this->filter);
+    this->filter = NULL;
+}
+
 void *treeset_minimum(TreeSet *this) {
     if (this->root == NULL) {
         return NULL;
@@ -237,35 +282,31 @@ void *treeset_maximum(TreeSet *this) {
 }
 
 bool treeset_contains(TreeSet *this, void *data) {
+    if (this->filter != NULL && !bloomfilter_contains(this->filter, data)) {
+        return false;
+    }
     TreeSetNode *current_node = this->root;
     while (current_node != NULL) {
-        switch (USE_CMP(this->data_methods, current_node->data,  data)) {
-            case 0:
-                return true;
-            case 1:
-                current_node = current_node->child[LEFT];
-                break;
-            default:
-                current_node = current_node->child[RIGHT];
-                break;
+        int cmp = USE_CMP(this->data_methods, current_node->data,  data);
+        if (cmp == 0) {
+            return true;
         }
+        current_node = current_node->child[cmp > 0 ? LEFT : RIGHT];
     }
     return false;
 }
 
 void *treeset_get_key(TreeSet *this, void *data) {
+    if (this->filter != NULL && !bloomfilter_contains(this->filter, data)) {
+        return NULL;
+    }
     TreeSetNode *current_node = this->root;
     while (current_node != NULL) {
-        switch (USE_CMP(this->data_methods, current_node->data,  data)) {
-            case 0:
-                return current_node->data;
-            case 1:
-                current_node = current_node->child[LEFT];
-                break;
-            default:
-                current_node = current_node->child[RIGHT];
-                break;
+        int cmp = USE_CMP(this->data_methods, current_node->data,  data);
+        if (cmp == 0) {
+            return current_node->data;
         }
+        current_node = current_node->child[cmp > 0 ? LEFT : RIGHT];
     }
     return NULL;
 }
@@ -297,31 +338,57 @@ inline size_t treeset_size(TreeSet *this) {
 
 void treeset_add(TreeSet *this, void *data) {
     if(treeset_contains(this, data)) return;
-    // void *new_data = USE_DUP(this->data_methods, data);
     if (data == NULL) {
         return;
     }
+    treeset_insert(this, USE_DUP(this->data_methods, data));
+}
+
+// Adopts data without copying it. When an equal element is already present the set keeps it and destroys data.
+void treeset_add_owned(TreeSet *this, void *data) {
+    if (data == NULL) {
+        return;
+    }
+    void *stored = treeset_get_key(this, data);
+    if (stored != NULL) {
+        if (stored != data) {
+            USE_DEL(this->data_methods, data);
+        }
+        return;
+    }
     treeset_insert(this, data);
-    this->size++;
-    return;
 }
 
 void treeset_remove(TreeSet *this, void *data) {
     if (this->root == NULL) {
         return;
     }
-    //if(!treeset_contains(this, data)) return;
-    treeset_delete(this, data);
-    this->size--;
+    USE_DEL(this->data_methods, treeset_take(this, data));
     return;
 }
 
+// Removes the element equal to data without destroying it, the caller takes ownership of the returned pointer.
+// NULL when data is absent.
+void *treeset_take(TreeSet *this, void *data) {
+    if (this->root == NULL) {
+        return NULL;
+    }
+    void *removed = treeset_delete(this, data);
+    if (removed != NULL) {
+        this->size--;
+    }
+    return removed;
+}
+
 void treeset_clear(TreeSet *this) {
     if (this == NULL || this->root == NULL) {
         return;
     }
     treeset_destroy_helper(this, this->root);
     this->size = 0;
+    if (this->filter != NULL) {
+        bloomfilter_clear(this->filter);
+    }
     return;
 }
 
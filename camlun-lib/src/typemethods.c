@@ -4,6 +4,7 @@
 #include <string.h>
 #include <stddef.h>
 #include "murmur3.h"
+#include "siphash.h"
 
 
 
@@ -51,12 +52,29 @@ int numerical_signed_comparator(size_t type_size, void *first, void *second) {
     ((*(type *)first > *(type *)second) ? 1 : (*(type *)first < *(type *)second) ? -1 \
                                                                                  : 0)
 
+// Small sizes are dispatched to kernels specialized for the common widths, the others go through MurmurHash3
 size_t numerical_hash_function(size_t type_size, void *ptr) {
+    switch (type_size) {
+        case 1: return (size_t)hash_kernel(ptr, 1, HASH_SEED);
+        case 2: return (size_t)hash_kernel(ptr, 2, HASH_SEED);
+        case 4: return (size_t)hash_kernel(ptr, 4, HASH_SEED);
+        case 8: return (size_t)hash_kernel(ptr, 8, HASH_SEED);
+        case 16: return (size_t)hash_kernel(ptr, 16, HASH_SEED);
+    }
+    if (type_size <= HASH_KERNEL_MAX_SIZE) {
+        return (size_t)hash_kernel(ptr, type_size, HASH_SEED);
+    }
     uint64_t hash_output[2];
     MurmurHash3_x64_128(ptr, type_size, HASH_SEED, hash_output);
     return (size_t)(hash_output[0] ^ hash_output[1]);
 }
 
+// SipHash with the 64 bit seed spread over both halves of its key, whatever the size. The kernels are not
+// used here: a key whose first word cancels HASH_KERNEL_P1 hashes the same under every seed
+size_t numerical_seeded_hash_function(size_t type_size, void *ptr, uint64_t seed) {
+    return (size_t)siphash13(ptr, type_size, seed, (seed << 32 | seed >> 32) ^ 0x9E3779B97F4A7C15ULL);
+}
+
 void *shallow_default_constructor() {
     return NULL;
 }
@@ -74,7 +92,11 @@ int shallow_comparator(void *first, void *second) {
 }
 
 size_t shallow_hash_function(void *ptr) {
-    return numerical_hash_function(sizeof(void *), ptr);  // Simple hash function for pointers
+    return numerical_hash_inline(sizeof(void *), ptr);  // Simple hash function for pointers
+}
+
+size_t shallow_seeded_hash_function(void *ptr, uint64_t seed) {
+    return numerical_seeded_hash_function(sizeof(void *), ptr, seed);
 }
 
 void *string_default_constructor() {
@@ -112,6 +134,10 @@ size_t string_hash_function(void *ptr) {
     return (size_t)(hash_output[0] ^ hash_output[1]);
 }
 
+size_t string_seeded_hash_function(void *ptr, uint64_t seed) {
+    return numerical_seeded_hash_function(strlen((char *)ptr), ptr, seed);
+}
+
 void *bool_default_constructor() { return numerical_default_constructor(sizeof(bool)); }
 void *char_default_constructor() { return numerical_default_constructor(sizeof(char)); }
 void *signed_char_default_constructor() { return numerical_default_constructor(sizeof(signed char)); }
@@ -409,117 +435,263 @@ int ptrdiff_t_comparator(void *first, void *second) {
 }
 
 size_t bool_hash_function(void *ptr) {
-    return numerical_hash_function(sizeof(bool), ptr);
+    return numerical_hash_inline(sizeof(bool), ptr);
 }
 
 size_t char_hash_function(void *ptr) {
-    return numerical_hash_function(sizeof(char), ptr);
+    return numerical_hash_inline(sizeof(char), ptr);
 }
 
 size_t signed_char_hash_function(void *ptr) {
-    return numerical_hash_function(sizeof(signed char), ptr);
+    return numerical_hash_inline(sizeof(signed char), ptr);
 }
 
 size_t unsigned_char_hash_function(void *ptr) {
-    return numerical_hash_function(sizeof(unsigned char), ptr);
+    return numerical_hash_inline(sizeof(unsigned char), ptr);
 }
 
 size_t short_hash_function(void *ptr) {
-    return numerical_hash_function(sizeof(short), ptr);
+    return numerical_hash_inline(sizeof(short), ptr);
 }
 
 size_t unsigned_short_hash_function(void *ptr) {
-    return numerical_hash_function(sizeof(unsigned short), ptr);
+    return numerical_hash_inline(sizeof(unsigned short), ptr);
 }
 
 size_t int_hash_function(void *ptr) {
-    return numerical_hash_function(sizeof(int), ptr);
+    return numerical_hash_inline(sizeof(int), ptr);
 }
 
 size_t unsigned_int_hash_function(void *ptr) {
-    return numerical_hash_function(sizeof(unsigned int), ptr);
+    return numerical_hash_inline(sizeof(unsigned int), ptr);
 }
 
 size_t long_hash_function(void *ptr) {
-    return numerical_hash_function(sizeof(long), ptr);
+    return numerical_hash_inline(sizeof(long), ptr);
 }
 
 size_t unsigned_long_hash_function(void *ptr) {
-    return numerical_hash_function(sizeof(unsigned long), ptr);
+    return numerical_hash_inline(sizeof(unsigned long), ptr);
 }
 
 size_t long_long_hash_function(void *ptr) {
-    return numerical_hash_function(sizeof(long long), ptr);
+    return numerical_hash_inline(sizeof(long long), ptr);
 }
 
 size_t unsigned_long_long_hash_function(void *ptr) {
-    return numerical_hash_function(sizeof(unsigned long long), ptr);
+    return numerical_hash_inline(sizeof(unsigned long long), ptr);
 }
 
 size_t float_hash_function(void *ptr) {
-    return numerical_hash_function(sizeof(float), ptr);
+    return numerical_hash_inline(sizeof(float), ptr);
 }
 
 size_t double_hash_function(void *ptr) {
-    return numerical_hash_function(sizeof(double), ptr);
+    return numerical_hash_inline(sizeof(double), ptr);
 }
 
 size_t long_double_hash_function(void *ptr) {
-    return numerical_hash_function(sizeof(long double), ptr);
+    return numerical_hash_inline(sizeof(long double), ptr);
 }
 
 size_t int8_t_hash_function(void *ptr) {
-    return numerical_hash_function(sizeof(int8_t), ptr);
+    return numerical_hash_inline(sizeof(int8_t), ptr);
 }
 
 size_t int16_t_hash_function(void *ptr) {
-    return numerical_hash_function(sizeof(int16_t), ptr);
+    return numerical_hash_inline(sizeof(int16_t), ptr);
 }
 
 size_t int32_t_hash_function(void *ptr) {
-    return numerical_hash_function(sizeof(int32_t), ptr);
+    return numerical_hash_inline(sizeof(int32_t), ptr);
 }
 
 size_t int64_t_hash_function(void *ptr) {
-    return numerical_hash_function(sizeof(int64_t), ptr);
+    return numerical_hash_inline(sizeof(int64_t), ptr);
 }
 
 size_t intmax_t_hash_function(void *ptr) {
-    return numerical_hash_function(sizeof(intmax_t), ptr);
+    return numerical_hash_inline(sizeof(intmax_t), ptr);
 }
 
 size_t intptr_t_hash_function(void *ptr) {
-    return numerical_hash_function(sizeof(intptr_t), ptr);
+    return numerical_hash_inline(sizeof(intptr_t), ptr);
 }
 
 size_t uint8_t_hash_function(void *ptr) {
-    return numerical_hash_function(sizeof(uint8_t), ptr);
+    return numerical_hash_inline(sizeof(uint8_t), ptr);
 }
 
 size_t uint16_t_hash_function(void *ptr) {
-    return numerical_hash_function(sizeof(uint16_t), ptr);
+    return numerical_hash_inline(sizeof(uint16_t), ptr);
 }
 
 size_t uint32_t_hash_function(void *ptr) {
-    return numerical_hash_function(sizeof(uint32_t), ptr);
+    return numerical_hash_inline(sizeof(uint32_t), ptr);
 }
 
 size_t uint64_t_hash_function(void *ptr) {
-    return numerical_hash_function(sizeof(uint64_t), ptr);
+    return numerical_hash_inline(sizeof(uint64_t), ptr);
 }
 
 size_t uintmax_t_hash_function(void *ptr) {
-    return numerical_hash_function(sizeof(uintmax_t), ptr);
+    return numerical_hash_inline(sizeof(uintmax_t), ptr);
 }
 
 size_t uintptr_t_hash_function(void *ptr) {
-    return numerical_hash_function(sizeof(uintptr_t), ptr);
+    return numerical_hash_inline(sizeof(uintptr_t), ptr);
 }
 
 size_t size_t_hash_function(void *ptr) {
-    return numerical_hash_function(sizeof(size_t), ptr);
+    return numerical_hash_inline(sizeof(size_t), ptr);
 }
 
 size_t ptrdiff_t_hash_function(void *ptr) {
-    return numerical_hash_function(sizeof(ptrdiff_t), ptr);
+    return numerical_hash_inline(sizeof(ptrdiff_t), ptr);
+}
+
+size_t bool_seeded_hash_function(void *ptr, uint64_t seed) {
+    return numerical_seeded_hash_function(sizeof(bool), ptr, seed);
+}
+
+size_t char_seeded_hash_function(void *ptr, uint64_t seed) {
+    return numerical_seeded_hash_function(sizeof(char), ptr, seed);
+}
+
+size_t signed_char_seeded_hash_function(void *ptr, uint64_t seed) {
+    return numerical_seeded_hash_function(sizeof(signed char), ptr, seed);
+}
+
+size_t unsigned_char_seeded_hash_function(void *ptr, uint64_t seed) {
+    return numerical_seeded_hash_function(sizeof(unsigned char), ptr, seed);
+}
+
+size_t short_seeded_hash_function(void *ptr, uint64_t seed) {
+    return numerical_seeded_hash_function(sizeof(short), ptr, seed);
+}
+
+size_t unsigned_short_seeded_hash_function(void *ptr, uint64_t seed) {
+    return numerical_seeded_hash_function(sizeof(unsigned short), ptr, seed);
+}
+
+size_t int_seeded_hash_function(void *ptr, uint64_t seed) {
+    return numerical_seeded_hash_function(sizeof(int), ptr, seed);
+}
+
+size_t unsigned_int_seeded_hash_function(void *ptr, uint64_t seed) {
+    return numerical_seeded_hash_function(sizeof(unsigned int), ptr, seed);
+}
+
+size_t long_seeded_hash_function(void *ptr, uint64_t seed) {
+    return numerical_seeded_hash_function(sizeof(long), ptr, seed);
+}
+
+size_t unsigned_long_seeded_hash_function(void *ptr, uint64_t seed) {
+    return numerical_seeded_hash_function(sizeof(unsigned long), ptr, seed);
+}
+
+size_t long_long_seeded_hash_function(void *ptr, uint64_t seed) {
+    return numerical_seeded_hash_function(sizeof(long long), ptr, seed);
+}
+
+size_t unsigned_long_long_seeded_hash_function(void *ptr, uint64_t seed) {
+    return numerical_seeded_hash_function(sizeof(unsigned long long), ptr, seed);
+}
+
+size_t float_seeded_hash_function(void *ptr, uint64_t seed) {
+    return numerical_seeded_hash_function(sizeof(float), ptr, seed);
+}
+
+size_t double_seeded_hash_function(void *ptr, uint64_t seed) {
+    return numerical_seeded_hash_function(sizeof(double), ptr, seed);
+}
+
+size_t long_double_seeded_hash_function(void *ptr, uint64_t seed) {
+    return numerical_seeded_hash_function(sizeof(long double), ptr, seed);
+}
+
+size_t int8_t_seeded_hash_function(void *ptr, uint64_t seed) {
+    return numerical_seeded_hash_function(sizeof(int8_t), ptr, seed);
+}
+
+size_t int16_t_seeded_hash_function(void *ptr, uint64_t seed) {
+    return numerical_seeded_hash_function(sizeof(int16_t), ptr, seed);
+}
+
+size_t int32_t_seeded_hash_function(void *ptr, uint64_t seed) {
+    return numerical_seeded_hash_function(sizeof(int32_t), ptr, seed);
+}
+
+size_t int64_t_seeded_hash_function(void *ptr, uint64_t seed) {
+    return numerical_seeded_hash_function(sizeof(int64_t), ptr, seed);
+}
+
+size_t intmax_t_seeded_hash_function(void *ptr, uint64_t seed) {
+    return numerical_seeded_hash_function(sizeof(intmax_t), ptr, seed);
+}
+
+size_t intptr_t_seeded_hash_function(void *ptr, uint64_t seed) {
+    return numerical_seeded_hash_function(sizeof(intptr_t), ptr, seed);
+}
+
+size_t uint8_t_seeded_hash_function(void *ptr, uint64_t seed) {
+    return numerical_seeded_hash_function(sizeof(uint8_t), ptr, seed);
+}
+
+size_t uint16_t_seeded_hash_function(void *ptr, uint64_t seed) {
+    return numerical_seeded_hash_function(sizeof(uint16_t), ptr, seed);
+}
+
+size_t uint32_t_seeded_hash_function(void *ptr, uint64_t seed) {
+    return numerical_seeded_hash_function(sizeof(uint32_t), ptr, seed);
+}
+
+size_t uint64_t_seeded_hash_function(void *ptr, uint64_t seed) {
+    return numerical_seeded_hash_function(sizeof(uint64_t), ptr, seed);
+}
+
+size_t uintmax_t_seeded_hash_function(void *ptr, uint64_t seed) {
+    return numerical_seeded_hash_function(sizeof(uintmax_t), ptr, seed);
+}
+
+size_t uintptr_t_seeded_hash_function(void *ptr, uint64_t seed) {
+    return numerical_seeded_hash_function(sizeof(uintptr_t), ptr, seed);
+}
+
+size_t size_t_seeded_hash_function(void *ptr, uint64_t seed) {
+    return numerical_seeded_hash_function(sizeof(size_t), ptr, seed);
+}
+
+size_t ptrdiff_t_seeded_hash_function(void *ptr, uint64_t seed) {
+    return numerical_seeded_hash_function(sizeof(ptrdiff_t), ptr, seed);
+}
+
+typedef struct {
+    hash_function hash;
+    seeded_hash_function seeded_hash;
+} SeededHashPair;
+
+#define SEEDED_HASH_PAIR(type) {type##_hash_function, type##_seeded_hash_function}
+
+static const SeededHashPair SEEDED_HASH_PAIRS[] = {
+    SEEDED_HASH_PAIR(bool), SEEDED_HASH_PAIR(char), SEEDED_HASH_PAIR(signed_char), SEEDED_HASH_PAIR(unsigned_char),
+    SEEDED_HASH_PAIR(short), SEEDED_HASH_PAIR(unsigned_short), SEEDED_HASH_PAIR(int), SEEDED_HASH_PAIR(unsigned_int),
+    SEEDED_HASH_PAIR(long), SEEDED_HASH_PAIR(unsigned_long), SEEDED_HASH_PAIR(long_long), SEEDED_HASH_PAIR(unsigned_long_long),
+    SEEDED_HASH_PAIR(float), SEEDED_HASH_PAIR(double), SEEDED_HASH_PAIR(long_double),
+    SEEDED_HASH_PAIR(int8_t), SEEDED_HASH_PAIR(int16_t), SEEDED_HASH_PAIR(int32_t), SEEDED_HASH_PAIR(int64_t),
+    SEEDED_HASH_PAIR(intmax_t), SEEDED_HASH_PAIR(intptr_t),
+    SEEDED_HASH_PAIR(uint8_t), SEEDED_HASH_PAIR(uint16_t), SEEDED_HASH_PAIR(uint32_t), SEEDED_HASH_PAIR(uint64_t),
+    SEEDED_HASH_PAIR(uintmax_t), SEEDED_HASH_PAIR(uintptr_t),
+    SEEDED_HASH_PAIR(size_t), SEEDED_HASH_PAIR(ptrdiff_t),
+    SEEDED_HASH_PAIR(string), SEEDED_HASH_PAIR(shallow),
+};
+
+// The seeded counterpart of a built-in hash function, NULL for any other
+seeded_hash_function builtin_seeded_hash_function(hash_function hash) {
+    for (size_t i = 0; hash != NULL && i < sizeof(SEEDED_HASH_PAIRS) / sizeof(SEEDED_HASH_PAIRS[0]); i++) {
+        if (SEEDED_HASH_PAIRS[i].hash == hash) {
+            return SEEDED_HASH_PAIRS[i].seeded_hash;
+        }
+    }
+    return NULL;
 }
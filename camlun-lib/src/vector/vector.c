@@ -2,6 +2,7 @@
 #include <assert.h>
 #include <stdbool.h>
 #include <stdlib.h>
+#include <string.h>
 
 #include "typemethods.h"
 #include "vector.h"
@@ -12,10 +13,13 @@
 
 size_t get_new_capacity(size_t target_capacity);
 void vector_node_init(Vector *vector, VectorNode *node, void *data);
+static Vector *vector_create_layout(size_t element_size, type_methods *data_methods);
+static void vector_swap_bytes(unsigned char *first, unsigned char *second, size_t size);
 
 // Constructors and destructors :
 
 Vector *vector_create(type_methods *data_methods);
+Vector *vector_create_sized(size_t element_size, type_methods *data_methods);
 void vector_destroy(Vector *this);
 
 // Access and iteration :
@@ -47,10 +51,20 @@ void vector_erase(Vector *this, size_t pos);
 void vector_push_back(Vector *this, void *data);
 void vector_pop_back(Vector *this);
 
+void vector_set_owned(Vector *this, size_t pos, void *data);
+void vector_insert_owned(Vector *this, size_t pos, void *data);
+void vector_push_back_owned(Vector *this, void *data);
+void *vector_take(Vector *this, size_t pos);
+
 VectorNode *vector_insert_at(Vector *this, VectorNode *node, void *data);
 VectorNode *vector_erase_at(Vector *this, VectorNode *node);
 void vector_replace(Vector *this, VectorNode *node, void *data);
 
+void vector_insert_range(Vector *this, size_t pos, void *data, size_t count);
+void vector_erase_range(Vector *this, size_t pos, size_t count);
+void vector_append(Vector *this, Vector *other);
+size_t vector_erase_if(Vector *this, vector_predicate predicate, void *context);
+
 void vector_truncate(Vector *this, size_t new_size);
 void vector_expand(Vector *this, size_t new_size);
 void vector_resize(Vector *this, size_t new_size);
@@ -81,18 +95,17 @@ void vector_node_init(Vector *vector, VectorNode *node, void *data) {
     }
 }
 
-// End of private methods
-
-Vector *vector_create(type_methods *data_methods) {
+static Vector *vector_create_layout(size_t element_size, type_methods *data_methods) {
     Vector *vector = malloc(sizeof(Vector));
     if (vector == NULL) {
         return NULL;
     }
     vector->size = 0;
     vector->data_methods = data_methods;
+    vector->element_size = element_size;
 
     vector->capacity = VECTOR_INITIAL_CAPACITY;
-    vector->nodes = calloc(vector->capacity, sizeof(VectorNode));
+    vector->nodes = calloc(vector->capacity, VECTOR_STRIDE(vector));
     if (vector->nodes == NULL) {
         free(vector);
         return NULL;
@@ -100,38 +113,70 @@ Vector *vector_create(type_methods *data_methods) {
     return vector;
 }
 
+static void vector_swap_bytes(unsigned char *first, unsigned char *second, size_t size) {
+    unsigned char temp[64];
+    while (size > 0) {
+        size_t chunk = size < sizeof(temp) ? size : sizeof(temp);
+        memcpy(temp, first, chunk);
+        memcpy(first, second, chunk);
+        memcpy(second, temp, chunk);
+        first += chunk;
+        second += chunk;
+        size -= chunk;
+    }
+}
+
+// End of private methods
+
+Vector *vector_create(type_methods *data_methods) {
+    return vector_create_layout(0, data_methods);
+}
+
+// Elements are copied in and out with memcpy and laid out back to back, so they must not own other memory.
+// data_methods only supply the comparator and the hash, the constructors and destructor are never called.
+Vector *vector_create_sized(size_t element_size, type_methods *data_methods) {
+    assert(element_size > 0);
+    return vector_create_layout(element_size, data_methods);
+}
+
 void vector_destroy(Vector *this) {
-    for (size_t i = 0; i < this->size; i++) {
-        USE_DEL(this->data_methods, this->nodes[i]);
+    if (!VECTOR_SIZED(this)) {
+        for (size_t i = 0; i < this->size; i++) {
+            USE_DEL(this->data_methods, this->nodes[i]);
+        }
     }
     free(this->nodes);
     free(this);
 }
 
+// The stored pointer, or for a sized vector a pointer to the element valid until the next insertion or removal
 void *vector_get(Vector *this, size_t pos) {
-    return *(void **)(this->nodes + pos);
+    return VECTOR_SIZED(this) ? VECTOR_ELEMENT(this, pos) : *(void **)(this->nodes + pos);
 }
 
 void *vector_first(Vector *this) {
     if (this->size == 0) return NULL;
-    return *(void **)(this->nodes);
+    return vector_get(this, 0);
 }
 
 void *vector_last(Vector *this) {
     if (this->size == 0) return NULL;
-    return *(void **)(this->nodes + this->size - 1);
+    return vector_get(this, this->size - 1);
 }
 
+// Node iterators step over pointers, sized vectors are walked by position or with VECTOR_FOREACH
 VectorNode *vector_at(Vector *this, size_t pos) {
-    assert(pos < this->size);
+    assert(pos < this->size && !VECTOR_SIZED(this));
     return this->nodes + pos;
 }
 
 VectorNode *vector_begin(Vector *this) {
+    assert(!VECTOR_SIZED(this));
     return this->nodes;
 }
 
 VectorNode *vector_end(Vector *this) {
+    assert(!VECTOR_SIZED(this));
     return this->nodes + this->size;
 }
 
@@ -141,6 +186,7 @@ void vector_increment(VectorNode **this) {
 }
 
 size_t vector_pos(Vector *this, VectorNode *node) {
+    assert(!VECTOR_SIZED(this));
     assert(node >= this->nodes && node <= this->nodes + this->size);
     return (size_t)(node - this->nodes);
 }
@@ -164,7 +210,7 @@ void vector_reserve(Vector *this, size_t new_capacity) {
         return;
     }
 
-    VectorNode *new_nodes = realloc(this->nodes, new_capacity * sizeof(VectorNode));
+    VectorNode *new_nodes = realloc(this->nodes, new_capacity * VECTOR_STRIDE(this));
     if (new_nodes == NULL) {
         return;
     }
@@ -177,7 +223,7 @@ void vector_reserve(Vector *this, size_t new_capacity) {
 void vector_compact(Vector *this) {
     size_t new_capacity = get_new_capacity(this->size);
 
-    VectorNode *new_nodes = realloc(this->nodes, new_capacity * sizeof(VectorNode));
+    VectorNode *new_nodes = realloc(this->nodes, new_capacity * VECTOR_STRIDE(this));
     if (new_nodes == NULL) {
         return;
     }
@@ -190,36 +236,64 @@ void vector_compact(Vector *this) {
 // Note : vector_set assumes there is existing data at pos, use vector_node_init to initialize new nodes
 void vector_set(Vector *this, size_t pos, void *data) {
     assert(pos < this->size);
-    USE_DEL(this->data_methods, (void*)(this->nodes[pos]));
-    this->nodes[pos] = USE_DUP(this->data_methods, data);
+    if (VECTOR_SIZED(this)) {
+        memcpy(VECTOR_ELEMENT(this, pos), data, this->element_size);
+        return;
+    }
+    vector_set_owned(this, pos, USE_DUP(this->data_methods, data));
     return;
 }
 
+void vector_set_owned(Vector *this, size_t pos, void *data) {
+    assert(pos < this->size && !VECTOR_SIZED(this));
+    USE_DEL(this->data_methods, this->nodes[pos]);
+    this->nodes[pos] = data;
+}
+
 void vector_insert(Vector *this, size_t pos, void *data) {
     assert(pos <= this->size);
     if (this->size >= this->capacity) {
         vector_reserve(this, this->size + 1);
     }
+    if (VECTOR_SIZED(this)) {
+        memmove(VECTOR_ELEMENT(this, pos + 1), VECTOR_ELEMENT(this, pos), (this->size - pos) * this->element_size);
+        memcpy(VECTOR_ELEMENT(this, pos), data, this->element_size);
+        this->size++;
+        return;
+    }
+    vector_insert_owned(this, pos, USE_DUP(this->data_methods, data));
+}
 
-    for (size_t i = this->size; i > pos; i--) {
-        this->nodes[i] = this->nodes[i - 1];
+// The _owned modifiers adopt data as it is, the vector destroys it later with the destructor
+void vector_insert_owned(Vector *this, size_t pos, void *data) {
+    assert(pos <= this->size && !VECTOR_SIZED(this));
+    if (this->size >= this->capacity) {
+        vector_reserve(this, this->size + 1);
     }
 
-    this->nodes[pos] = NULL;
-    vector_node_init(this, this->nodes + pos, data);
+    memmove(this->nodes + pos + 1, this->nodes + pos, (this->size - pos) * sizeof(VectorNode));
+    this->nodes[pos] = data;
     this->size++;
 }
 
 void vector_erase(Vector *this, size_t pos) {
     assert(pos < this->size);
-    USE_DEL(this->data_methods, this->nodes[pos]);
-
-    for (size_t i = pos; i < this->size - 1; i++) {
-        this->nodes[i] = this->nodes[i + 1];
+    if (VECTOR_SIZED(this)) {
+        memmove(VECTOR_ELEMENT(this, pos), VECTOR_ELEMENT(this, pos + 1), (this->size - pos - 1) * this->element_size);
+        this->size--;
+        return;
     }
+    USE_DEL(this->data_methods, vector_take(this, pos));
+}
 
+// Removes the element at pos without destroying it, the caller takes ownership of the returned pointer
+void *vector_take(Vector *this, size_t pos) {
+    assert(pos < this->size && !VECTOR_SIZED(this));
+    void *data = this->nodes[pos];
+    memmove(this->nodes + pos, this->nodes + pos + 1, (this->size - pos - 1) * sizeof(VectorNode));
     this->nodes[this->size - 1] = NULL;
     this->size--;
+    return data;
 }
 
 // Return the iterator for continue to iterate
@@ -248,19 +322,115 @@ void vector_push_back(Vector *this, void *data) {
     if (this->size >= this->capacity) {
         vector_reserve(this, this->size + 1);
     }
-    vector_node_init(this, this->nodes + this->size, data);
-    this->size++;
+    if (VECTOR_SIZED(this)) {
+        memcpy(VECTOR_ELEMENT(this, this->size), data, this->element_size);
+        this->size++;
+        return;
+    }
+    vector_push_back_owned(this, USE_DUP(this->data_methods, data));
+}
+
+void vector_push_back_owned(Vector *this, void *data) {
+    assert(!VECTOR_SIZED(this));
+    if (this->size >= this->capacity) {
+        vector_reserve(this, this->size + 1);
+    }
+    this->nodes[this->size++] = data;
 }
 
 void vector_pop_back(Vector *this) {
     assert(this->size > 0);
     this->size--;
+    if (VECTOR_SIZED(this)) {
+        return;
+    }
     USE_DEL(this->data_methods, this->nodes[this->size]);
     this->nodes[this->size] = NULL;
 }
 
+// Inserts count elements before pos with one shift. data holds count pointers for a pointer vector,
+// each copied in with the constructor, and count elements back to back for a sized vector. data may point into this vector.
+void vector_insert_range(Vector *this, size_t pos, void *data, size_t count) {
+    assert(pos <= this->size);
+    if (count == 0) {
+        return;
+    }
+    size_t stride = VECTOR_STRIDE(this);
+    // A range of this vector is copied out first, since reserving may move it and the shift may overwrite it
+    void *copy = NULL;
+    uintptr_t address = (uintptr_t)data;
+    if (address >= (uintptr_t)this->nodes && address < (uintptr_t)this->nodes + this->capacity * stride) {
+        copy = malloc(count * stride);
+        if (copy == NULL) {
+            return;
+        }
+        memcpy(copy, data, count * stride);
+        data = copy;
+    }
+    vector_reserve(this, this->size + count);
+    if (this->capacity < this->size + count) {
+        free(copy);
+        return;
+    }
+    unsigned char *nodes = (unsigned char *)this->nodes;
+    memmove(nodes + (pos + count) * stride, nodes + pos * stride, (this->size - pos) * stride);
+    if (VECTOR_SIZED(this)) {
+        memcpy(nodes + pos * stride, data, count * stride);
+    } else {
+        for (size_t i = 0; i < count; i++) {
+            this->nodes[pos + i] = USE_DUP(this->data_methods, ((void **)data)[i]);
+        }
+    }
+    this->size += count;
+    free(copy);
+}
+
+// Erases the count elements from pos with one shift
+void vector_erase_range(Vector *this, size_t pos, size_t count) {
+    assert(pos <= this->size && count <= this->size - pos);
+    if (!VECTOR_SIZED(this)) {
+        for (size_t i = pos; i < pos + count; i++) {
+            USE_DEL(this->data_methods, this->nodes[i]);
+        }
+    }
+    size_t stride = VECTOR_STRIDE(this);
+    unsigned char *nodes = (unsigned char *)this->nodes;
+    memmove(nodes + pos * stride, nodes + (pos + count) * stride, (this->size - pos - count) * stride);
+    this->size -= count;
+}
+
+// Copies every element of other to the end, other must have the same layout and may be this vector or a slice of it
+void vector_append(Vector *this, Vector *other) {
+    assert(this->element_size == other->element_size);
+    vector_insert_range(this, this->size, other->nodes, other->size);
+}
+
+// Erases every element predicate holds for in one pass, the others keep their order. Returns how many were erased.
+// predicate gets the element as vector_get returns it.
+size_t vector_erase_if(Vector *this, vector_predicate predicate, void *context) {
+    size_t stride = VECTOR_STRIDE(this);
+    unsigned char *nodes = (unsigned char *)this->nodes;
+    size_t kept = 0;
+    for (size_t i = 0; i < this->size; i++) {
+        void *data = vector_get(this, i);
+        if (predicate(data, context)) {
+            if (!VECTOR_SIZED(this)) {
+                USE_DEL(this->data_methods, data);
+            }
+            continue;
+        }
+        if (kept != i) {
+            memcpy(nodes + kept * stride, nodes + i * stride, stride);
+        }
+        kept++;
+    }
+    size_t erased = this->size - kept;
+    this->size = kept;
+    return erased;
+}
+
 void vector_truncate(Vector *this, size_t new_size) {
-    for (size_t i = new_size; i < this->size; i++) {
+    for (size_t i = new_size; i < this->size && !VECTOR_SIZED(this); i++) {
         USE_DEL(this->data_methods, this->nodes[i]);
     }
     this->size = new_size;
@@ -270,6 +440,12 @@ void vector_expand(Vector *this, size_t new_size) {
     if (new_size > this->capacity) {
         vector_reserve(this, new_size);
     }
+    // New elements of a sized vector are zeroed
+    if (VECTOR_SIZED(this)) {
+        memset(VECTOR_ELEMENT(this, this->size), 0, (new_size - this->size) * this->element_size);
+        this->size = new_size;
+        return;
+    }
     for (size_t i = this->size; i < new_size; i++) {
         this->nodes[i] = USE_CRT(this->data_methods);
     }
@@ -285,7 +461,7 @@ void vector_resize(Vector *this, size_t new_size) {
 }
 
 void vector_clear(Vector *this) {
-    for (size_t i = 0; i < this->size; i++) {
+    for (size_t i = 0; i < this->size && !VECTOR_SIZED(this); i++) {
         USE_DEL(this->data_methods, this->nodes[i]);
     }
     this->size = 0;
@@ -293,17 +469,28 @@ void vector_clear(Vector *this) {
 
 void vector_swap(Vector *this, size_t pos1, size_t pos2) {
     assert(pos1 < this->size && pos2 < this->size);
+    if (VECTOR_SIZED(this)) {
+        if (pos1 != pos2) {
+            vector_swap_bytes(VECTOR_ELEMENT(this, pos1), VECTOR_ELEMENT(this, pos2), this->element_size);
+        }
+        return;
+    }
     VectorNode temp = this->nodes[pos1];
     this->nodes[pos1] = this->nodes[pos2];
     this->nodes[pos2] = temp;
 }
 
 Vector *vector_clone(Vector *this, type_methods *new_data_methods) {
-    Vector *clone = vector_create(new_data_methods);
+    Vector *clone = vector_create_layout(this->element_size, new_data_methods);
     if (clone == NULL) {
         return NULL;
     }
     vector_reserve(clone, this->size);
+    if (VECTOR_SIZED(this)) {
+        memcpy(clone->nodes, this->nodes, this->size * this->element_size);
+        clone->size = this->size;
+        return clone;
+    }
     for (size_t i = 0; i < this->size; i++) {
         clone->nodes[i] = USE_DUP(this->data_methods, this->nodes[i]);
     }
@@ -314,7 +501,8 @@ Vector *vector_clone(Vector *this, type_methods *new_data_methods) {
 Vector vector_slice(Vector *this, size_t offset, size_t count) {
     Vector slice;
     slice.data_methods = this->data_methods;
-    slice.nodes = this->nodes + offset;
+    slice.element_size = this->element_size;
+    slice.nodes = VECTOR_SIZED(this) ? VECTOR_ELEMENT(this, offset) : this->nodes + offset;
     slice.size = count;
     slice.capacity = count;
     return slice;
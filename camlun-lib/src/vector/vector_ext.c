@@ -2,8 +2,12 @@
 
 #include "vector.h"
 #include <stdlib.h>
+#include <string.h>
 #include <stddef.h>
 #include <stdbool.h>
+#include <stdint.h>
+#include <limits.h>
+#include <pthread.h>
 #include "typemethods.h"
 #include <assert.h>
 
@@ -76,62 +80,1062 @@ void heap_update(Vector *this, size_t pos, void *data, bool is_max) {
     vector_heapify(this, pos, is_max);
 }
 
+// For a sized vector the polled element is returned in a malloc'd copy which the caller frees
 void *heap_poll(Vector *this, bool is_max) {
     if(this->size == 0){
         return NULL;
     }
-    VectorNode *first_node = vector_begin(this);
-    void *polled_data = *first_node;
-    *first_node = NULL;
+    if(VECTOR_SIZED(this)) {
+        void *polled_data = malloc(this->element_size);
+        if(polled_data == NULL) {
+            return NULL;
+        }
+        heap_poll_into(this, polled_data, is_max);
+        return polled_data;
+    }
     vector_swap(this, 0, this->size - 1);
-    this->size--;
+    void *polled_data = vector_take(this, this->size - 1);
     vector_heapify(this, 0, is_max);
     return polled_data;
 }
 
+// Sized vectors only, copies the top element into out without allocating
+bool heap_poll_into(Vector *this, void *out, bool is_max) {
+    assert(VECTOR_SIZED(this));
+    if(this->size == 0) {
+        return false;
+    }
+    memcpy(out, vector_first(this), this->element_size);
+    vector_swap(this, 0, this->size - 1);
+    this->size--;
+    vector_heapify(this, 0, is_max);
+    return true;
+}
+
 void heap_offer(Vector *this, void *data, bool is_max) {
     vector_push_back(this, data);
     heap_sift_up(this, this->size - 1, is_max);
 }
 
-static void vector_qsort_helper(Vector *this, size_t start, size_t end, bool desc) {
-    if(start >= end) {
-        return;
+// Adopts data without copying it, heap_poll hands it back to the caller
+void heap_offer_owned(Vector *this, void *data, bool is_max) {
+    vector_push_back_owned(this, data);
+    heap_sift_up(this, this->size - 1, is_max);
+}
+
+
+// Sorting works on element slots, the stored pointer of a boxed vector or the element itself of a sized one
+
+// Ranges shorter than this are insertion sorted
+#define SORT_INSERTION_THRESHOLD 24
+// Ranges longer than this take the pseudomedian of nine as pivot
+#define SORT_NINTHER_THRESHOLD 128
+// Moves partial insertion sort makes before giving up on a nearly sorted range
+#define SORT_PARTIAL_INSERTION_LIMIT 8
+// Runs merge sort leaves to insertion sort
+#define SORT_MERGE_RUN 16
+// Elements whose two scratch slots fit on the stack
+#define SORT_SCRATCH_SIZE 128
+
+typedef struct {
+    type_methods *methods;
+    int (*cmp)(void *first, void *second);
+    size_t stride;
+    bool boxed;
+    bool descending;
+    unsigned char *temp;       // Holds the pivot or the element being inserted
+    unsigned char *swap_temp;
+} VectorSort;
+
+static inline bool sort_less(VectorSort *sort, unsigned char *first, unsigned char *second) {
+    void *left = sort->boxed ? *(void **)first : (void *)first;
+    void *right = sort->boxed ? *(void **)second : (void *)second;
+    if (sort->cmp == NULL) {
+        return sort->descending ? USE_CMP(sort->methods, right, left) < 0 : USE_CMP(sort->methods, left, right) < 0;
     }
+    return sort->descending ? sort->cmp(right, left) < 0 : sort->cmp(left, right) < 0;
+}
+
+// Fixed size copies for the common strides, so they compile to single loads and stores
+static inline void sort_move(VectorSort *sort, unsigned char *destination, unsigned char *source) {
+    switch (sort->stride) {
+        case 4:
+            memcpy(destination, source, 4);
+            break;
+        case 8:
+            memcpy(destination, source, 8);
+            break;
+        default:
+            memcpy(destination, source, sort->stride);
+            break;
+    }
+}
+
+static inline void sort_swap(VectorSort *sort, unsigned char *first, unsigned char *second) {
+    if (sort->stride == 8) {
+        uint64_t temp;
+        memcpy(&temp, first, 8);
+        memcpy(first, second, 8);
+        memcpy(second, &temp, 8);
+    } else if (sort->stride == 4) {
+        uint32_t temp;
+        memcpy(&temp, first, 4);
+        memcpy(first, second, 4);
+        memcpy(second, &temp, 4);
+    } else if (sort->swap_temp != NULL) {
+        memcpy(sort->swap_temp, first, sort->stride);
+        memcpy(first, second, sort->stride);
+        memcpy(second, sort->swap_temp, sort->stride);
+    } else {
+        // Without scratch slots the elements are swapped a chunk at a time through the stack
+        unsigned char chunk[SORT_SCRATCH_SIZE];
+        for (size_t offset = 0; offset < sort->stride; offset += sizeof(chunk)) {
+            size_t size = sort->stride - offset < sizeof(chunk) ? sort->stride - offset : sizeof(chunk);
+            memcpy(chunk, first + offset, size);
+            memcpy(first + offset, second + offset, size);
+            memcpy(second + offset, chunk, size);
+        }
+    }
+}
+
+static inline void sort_sort2(VectorSort *sort, unsigned char *first, unsigned char *second) {
+    if (sort_less(sort, second, first)) {
+        sort_swap(sort, first, second);
+    }
+}
 
-    size_t pivot = start + (end - start) / 2;
-    void *pivot_value = vector_get(this, pivot);
-    size_t left = start;
-    size_t right = end;
+static void sort_sort3(VectorSort *sort, unsigned char *first, unsigned char *second, unsigned char *third) {
+    sort_sort2(sort, first, second);
+    sort_sort2(sort, second, third);
+    sort_sort2(sort, first, second);
+}
 
-    while(left <= right) {
-        if(desc) {
-            while(left < end && USE_CMP(this->data_methods, vector_get(this, left), pivot_value) > 0) {
-                left++;
+// Stable, equal elements are never moved past each other
+static void sort_insertion(VectorSort *sort, unsigned char *begin, unsigned char *end) {
+    size_t stride = sort->stride;
+    for (unsigned char *current = begin + stride; current < end; current += stride) {
+        if (!sort_less(sort, current, current - stride)) {
+            continue;
+        }
+        unsigned char *hole = current;
+        sort_move(sort, sort->temp, current);
+        do {
+            sort_move(sort, hole, hole - stride);
+            hole -= stride;
+        } while (hole != begin && sort_less(sort, sort->temp, hole - stride));
+        sort_move(sort, hole, sort->temp);
+    }
+}
+
+// Stable like sort_insertion, but moves elements by adjacent swaps only so it needs no scratch slots
+static void sort_insertion_by_swaps(VectorSort *sort, unsigned char *begin, unsigned char *end) {
+    size_t stride = sort->stride;
+    for (unsigned char *current = begin + stride; current < end; current += stride) {
+        for (unsigned char *position = current; position != begin && sort_less(sort, position, position - stride); position -= stride) {
+            sort_swap(sort, position - stride, position);
+        }
+    }
+}
+
+// The element before begin must not be greater than any in the range, it stops the scan instead of a bounds check
+static void sort_unguarded_insertion(VectorSort *sort, unsigned char *begin, unsigned char *end) {
+    size_t stride = sort->stride;
+    for (unsigned char *current = begin + stride; current < end; current += stride) {
+        if (!sort_less(sort, current, current - stride)) {
+            continue;
+        }
+        unsigned char *hole = current;
+        sort_move(sort, sort->temp, current);
+        do {
+            sort_move(sort, hole, hole - stride);
+            hole -= stride;
+        } while (sort_less(sort, sort->temp, hole - stride));
+        sort_move(sort, hole, sort->temp);
+    }
+}
+
+// Insertion sorts the range unless it takes more than SORT_PARTIAL_INSERTION_LIMIT moves, returns whether it finished
+static bool sort_partial_insertion(VectorSort *sort, unsigned char *begin, unsigned char *end) {
+    size_t stride = sort->stride;
+    size_t moves = 0;
+    for (unsigned char *current = begin + stride; current < end; current += stride) {
+        if (!sort_less(sort, current, current - stride)) {
+            continue;
+        }
+        unsigned char *hole = current;
+        sort_move(sort, sort->temp, current);
+        do {
+            sort_move(sort, hole, hole - stride);
+            hole -= stride;
+        } while (hole != begin && sort_less(sort, sort->temp, hole - stride));
+        sort_move(sort, hole, sort->temp);
+        moves += (size_t)(current - hole) / stride;
+        if (moves > SORT_PARTIAL_INSERTION_LIMIT && current + stride < end) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static void sort_sift_down(VectorSort *sort, unsigned char *begin, size_t pos, size_t count) {
+    size_t stride = sort->stride;
+    while (HEAP_LCHILD(pos) < count) {
+        size_t child = HEAP_LCHILD(pos);
+        if (child + 1 < count && sort_less(sort, begin + child * stride, begin + (child + 1) * stride)) {
+            child++;
+        }
+        if (!sort_less(sort, begin + pos * stride, begin + child * stride)) {
+            return;
+        }
+        sort_swap(sort, begin + pos * stride, begin + child * stride);
+        pos = child;
+    }
+}
+
+// Fallback once too many partitions were unbalanced, keeps the worst case at O(n log n).
+// Only compares and swaps, so it also sorts when the scratch slots could not be allocated.
+static void sort_heapsort(VectorSort *sort, unsigned char *begin, unsigned char *end) {
+    size_t count = (size_t)(end - begin) / sort->stride;
+    for (size_t i = count / 2; i-- > 0;) {
+        sort_sift_down(sort, begin, i, count);
+    }
+    for (size_t last = count - 1; last > 0; last--) {
+        sort_swap(sort, begin, begin + last * sort->stride);
+        sort_sift_down(sort, begin, 0, last);
+    }
+}
+
+// Partitions around the pivot at begin, elements equal to it go right. Reports whether no element had to move.
+static unsigned char *sort_partition_right(VectorSort *sort, unsigned char *begin, unsigned char *end, bool *already_partitioned) {
+    size_t stride = sort->stride;
+    unsigned char *pivot = sort->temp;
+    sort_move(sort, pivot, begin);
+    unsigned char *first = begin;
+    unsigned char *last = end;
+
+    // The pivot was a median, so an element at least as large stops the first scan
+    do {
+        first += stride;
+    } while (sort_less(sort, first, pivot));
+
+    if (first - stride == begin) {
+        while (first < last) {
+            last -= stride;
+            if (sort_less(sort, last, pivot)) {
+                break;
             }
-            while(right > start && USE_CMP(this->data_methods, vector_get(this, right), pivot_value) < 0) {
-                right--;
+        }
+    } else {
+        do {
+            last -= stride;
+        } while (!sort_less(sort, last, pivot));
+    }
+
+    *already_partitioned = first >= last;
+    while (first < last) {
+        sort_swap(sort, first, last);
+        do {
+            first += stride;
+        } while (sort_less(sort, first, pivot));
+        do {
+            last -= stride;
+        } while (!sort_less(sort, last, pivot));
+    }
+
+    unsigned char *pivot_pos = first - stride;
+    sort_move(sort, begin, pivot_pos);
+    sort_move(sort, pivot_pos, pivot);
+    return pivot_pos;
+}
+
+// Partitions around the pivot at begin, elements equal to it go left. Used when the pivot equals the element
+// before the range, then the whole left side is equal to it and needs no further sorting.
+static unsigned char *sort_partition_left(VectorSort *sort, unsigned char *begin, unsigned char *end) {
+    size_t stride = sort->stride;
+    unsigned char *pivot = sort->temp;
+    sort_move(sort, pivot, begin);
+    unsigned char *first = begin;
+    unsigned char *last = end;
+
+    do {
+        last -= stride;
+    } while (sort_less(sort, pivot, last));
+
+    if (last + stride == end) {
+        while (first < last) {
+            first += stride;
+            if (sort_less(sort, pivot, first)) {
+                break;
+            }
+        }
+    } else {
+        do {
+            first += stride;
+        } while (!sort_less(sort, pivot, first));
+    }
+
+    while (first < last) {
+        sort_swap(sort, first, last);
+        do {
+            last -= stride;
+        } while (sort_less(sort, pivot, last));
+        do {
+            first += stride;
+        } while (!sort_less(sort, pivot, first));
+    }
+
+    unsigned char *pivot_pos = last;
+    sort_move(sort, begin, pivot_pos);
+    sort_move(sort, pivot_pos, pivot);
+    return pivot_pos;
+}
+
+// Pattern-defeating quicksort : sorted and reversed runs finish in linear time, runs of equal elements are
+// split off whole, and after bad_allowed unbalanced partitions the range falls back to heapsort.
+static void sort_pdqsort(VectorSort *sort, unsigned char *begin, unsigned char *end, int bad_allowed, bool leftmost) {
+    size_t stride = sort->stride;
+    while (true) {
+        size_t size = (size_t)(end - begin) / stride;
+        if (size < SORT_INSERTION_THRESHOLD) {
+            if (leftmost) {
+                sort_insertion(sort, begin, end);
+            } else {
+                sort_unguarded_insertion(sort, begin, end);
             }
+            return;
+        }
+
+        // The chosen pivot ends up at begin
+        size_t half = size / 2;
+        if (size > SORT_NINTHER_THRESHOLD) {
+            sort_sort3(sort, begin, begin + half * stride, end - stride);
+            sort_sort3(sort, begin + stride, begin + (half - 1) * stride, end - 2 * stride);
+            sort_sort3(sort, begin + 2 * stride, begin + (half + 1) * stride, end - 3 * stride);
+            sort_sort3(sort, begin + (half - 1) * stride, begin + half * stride, begin + (half + 1) * stride);
+            sort_swap(sort, begin, begin + half * stride);
         } else {
-            while(left < end && USE_CMP(this->data_methods, vector_get(this, left), pivot_value) < 0) {
-                left++;
+            sort_sort3(sort, begin + half * stride, begin, end - stride);
+        }
+
+        if (!leftmost && !sort_less(sort, begin - stride, begin)) {
+            begin = sort_partition_left(sort, begin, end) + stride;
+            continue;
+        }
+
+        bool already_partitioned;
+        unsigned char *pivot_pos = sort_partition_right(sort, begin, end, &already_partitioned);
+        size_t left_size = (size_t)(pivot_pos - begin) / stride;
+        size_t right_size = (size_t)(end - pivot_pos) / stride - 1;
+
+        if (left_size < size / 8 || right_size < size / 8) {
+            if (--bad_allowed == 0) {
+                sort_heapsort(sort, begin, end);
+                return;
+            }
+            // Shuffle a few elements on each side to break up the pattern that fooled the pivot choice
+            if (left_size >= SORT_INSERTION_THRESHOLD) {
+                size_t quarter = left_size / 4;
+                sort_swap(sort, begin, begin + quarter * stride);
+                sort_swap(sort, pivot_pos - stride, pivot_pos - quarter * stride);
+                if (left_size > SORT_NINTHER_THRESHOLD) {
+                    sort_swap(sort, begin + stride, begin + (quarter + 1) * stride);
+                    sort_swap(sort, begin + 2 * stride, begin + (quarter + 2) * stride);
+                    sort_swap(sort, pivot_pos - 2 * stride, pivot_pos - (quarter + 1) * stride);
+                    sort_swap(sort, pivot_pos - 3 * stride, pivot_pos - (quarter + 2) * stride);
+                }
             }
-            while(right > start && USE_CMP(this->data_methods, vector_get(this, right), pivot_value) > 0) {
-                right--;
+            if (right_size >= SORT_INSERTION_THRESHOLD) {
+                size_t quarter = right_size / 4;
+                sort_swap(sort, pivot_pos + stride, pivot_pos + (quarter + 1) * stride);
+                sort_swap(sort, end - stride, end - quarter * stride);
+                if (right_size > SORT_NINTHER_THRESHOLD) {
+                    sort_swap(sort, pivot_pos + 2 * stride, pivot_pos + (quarter + 2) * stride);
+                    sort_swap(sort, pivot_pos + 3 * stride, pivot_pos + (quarter + 3) * stride);
+                    sort_swap(sort, end - 2 * stride, end - (quarter + 1) * stride);
+                    sort_swap(sort, end - 3 * stride, end - (quarter + 2) * stride);
+                }
+            }
+        } else if (already_partitioned && sort_partial_insertion(sort, begin, pivot_pos) &&
+                   sort_partial_insertion(sort, pivot_pos + stride, end)) {
+            return;
+        }
+
+        sort_pdqsort(sort, begin, pivot_pos, bad_allowed, leftmost);
+        begin = pivot_pos + stride;
+        leftmost = false;
+    }
+}
+
+// Merges the sorted halves [begin, middle) and [middle, end), the left half is first moved to buffer
+static void sort_merge(VectorSort *sort, unsigned char *begin, unsigned char *middle, unsigned char *end, unsigned char *buffer) {
+    size_t stride = sort->stride;
+    memcpy(buffer, begin, (size_t)(middle - begin));
+    unsigned char *left = buffer;
+    unsigned char *left_end = buffer + (middle - begin);
+    unsigned char *right = middle;
+    unsigned char *out = begin;
+    while (left < left_end && right < end) {
+        // Taking from the left on ties keeps the sort stable
+        if (sort_less(sort, right, left)) {
+            sort_move(sort, out, right);
+            right += stride;
+        } else {
+            sort_move(sort, out, left);
+            left += stride;
+        }
+        out += stride;
+    }
+    memcpy(out, left, (size_t)(left_end - left));
+}
+
+static void sort_merge_sort(VectorSort *sort, unsigned char *begin, unsigned char *end, unsigned char *buffer) {
+    size_t stride = sort->stride;
+    size_t size = (size_t)(end - begin) / stride;
+    if (size <= SORT_MERGE_RUN) {
+        sort_insertion(sort, begin, end);
+        return;
+    }
+    unsigned char *middle = begin + (size / 2) * stride;
+    sort_merge_sort(sort, begin, middle, buffer);
+    sort_merge_sort(sort, middle, end, buffer);
+    if (sort_less(sort, middle, middle - stride)) {
+        sort_merge(sort, begin, middle, end, buffer);
+    }
+}
+
+// Reverses the range when every element is strictly less than the one before, there are then no equal elements
+// whose order a reversal could break. Gives up at the first pair that is not.
+static bool sort_reverse_descending(VectorSort *sort, unsigned char *begin, unsigned char *end) {
+    size_t stride = sort->stride;
+    for (unsigned char *current = begin + stride; current < end; current += stride) {
+        if (!sort_less(sort, current, current - stride)) {
+            return false;
+        }
+    }
+    for (unsigned char *last = end - stride; begin < last; begin += stride, last -= stride) {
+        sort_swap(sort, begin, last);
+    }
+    return true;
+}
+
+static void vector_sort_layout(VectorSort *sort, Vector *this, bool descending) {
+    sort->methods = this->data_methods;
+    sort->cmp = this->data_methods != NULL ? this->data_methods->cmp : NULL;
+    sort->stride = VECTOR_STRIDE(this);
+    sort->boxed = !VECTOR_SIZED(this);
+    sort->descending = descending;
+    sort->temp = NULL;
+    sort->swap_temp = NULL;
+}
+
+// Scratch slots come from the caller's stack buffer when they fit. False if they could not be allocated,
+// the sort can then only compare and swap elements.
+static bool vector_sort_init(VectorSort *sort, Vector *this, bool descending, unsigned char *scratch) {
+    vector_sort_layout(sort, this, descending);
+    sort->temp = 2 * sort->stride <= SORT_SCRATCH_SIZE ? scratch : malloc(2 * sort->stride);
+    sort->swap_temp = sort->temp != NULL ? sort->temp + sort->stride : NULL;
+    return sort->temp != NULL;
+}
+
+static void vector_sort_release(VectorSort *sort, unsigned char *scratch) {
+    if (sort->temp != scratch) {
+        free(sort->temp);
+    }
+}
+
+// Radix sorting orders elements by unsigned 64 bit keys, one byte per pass from the least significant.
+// Built-in numeric types are keyed from their bits : signed values have the sign bit flipped, floating point
+// values have every bit flipped when negative and only the sign bit otherwise. Descending sorts complement the keys.
+
+// Below this many elements vector_sort and vector_stable_sort keep to comparisons
+#define RADIX_SORT_THRESHOLD 512
+#define RADIX_BUCKETS 256
+
+typedef enum {
+    RADIX_UNSIGNED,
+    RADIX_SIGNED,
+    RADIX_FLOAT
+} radix_kind;
+
+typedef struct {
+    int (*cmp)(void *first, void *second);
+    size_t width;
+    radix_kind kind;
+} RadixType;
+
+// The built-in numeric types, recognized by their comparator. long double has no portable bit layout and is left out.
+static const RadixType RADIX_TYPES[] = {
+    {bool_comparator, sizeof(bool), RADIX_UNSIGNED},
+    {char_comparator, sizeof(char), CHAR_MIN < 0 ? RADIX_SIGNED : RADIX_UNSIGNED},
+    {signed_char_comparator, sizeof(signed char), RADIX_SIGNED},
+    {unsigned_char_comparator, sizeof(unsigned char), RADIX_UNSIGNED},
+    {short_comparator, sizeof(short), RADIX_SIGNED},
+    {unsigned_short_comparator, sizeof(unsigned short), RADIX_UNSIGNED},
+    {int_comparator, sizeof(int), RADIX_SIGNED},
+    {unsigned_int_comparator, sizeof(unsigned int), RADIX_UNSIGNED},
+    {long_comparator, sizeof(long), RADIX_SIGNED},
+    {unsigned_long_comparator, sizeof(unsigned long), RADIX_UNSIGNED},
+    {long_long_comparator, sizeof(long long), RADIX_SIGNED},
+    {unsigned_long_long_comparator, sizeof(unsigned long long), RADIX_UNSIGNED},
+    {float_comparator, sizeof(float), RADIX_FLOAT},
+    {double_comparator, sizeof(double), RADIX_FLOAT},
+    {int8_t_comparator, sizeof(int8_t), RADIX_SIGNED},
+    {int16_t_comparator, sizeof(int16_t), RADIX_SIGNED},
+    {int32_t_comparator, sizeof(int32_t), RADIX_SIGNED},
+    {int64_t_comparator, sizeof(int64_t), RADIX_SIGNED},
+    {intmax_t_comparator, sizeof(intmax_t), RADIX_SIGNED},
+    {intptr_t_comparator, sizeof(intptr_t), RADIX_SIGNED},
+    {uint8_t_comparator, sizeof(uint8_t), RADIX_UNSIGNED},
+    {uint16_t_comparator, sizeof(uint16_t), RADIX_UNSIGNED},
+    {uint32_t_comparator, sizeof(uint32_t), RADIX_UNSIGNED},
+    {uint64_t_comparator, sizeof(uint64_t), RADIX_UNSIGNED},
+    {uintmax_t_comparator, sizeof(uintmax_t), RADIX_UNSIGNED},
+    {uintptr_t_comparator, sizeof(uintptr_t), RADIX_UNSIGNED},
+    {size_t_comparator, sizeof(size_t), RADIX_UNSIGNED},
+    {ptrdiff_t_comparator, sizeof(ptrdiff_t), RADIX_SIGNED},
+};
+
+// A key with its element, the stored pointer of a boxed vector or the position in a sized one
+typedef struct {
+    uint64_t key;
+    uintptr_t payload;
+} RadixItem;
+
+static const RadixType *radix_type(Vector *this) {
+    if (this->data_methods == NULL || this->data_methods->cmp == NULL) {
+        return NULL;
+    }
+    for (size_t i = 0; i < sizeof(RADIX_TYPES) / sizeof(RADIX_TYPES[0]); i++) {
+        if (RADIX_TYPES[i].cmp == this->data_methods->cmp) {
+            // The width must also match what a sized vector stores
+            if (VECTOR_SIZED(this) && this->element_size != RADIX_TYPES[i].width) {
+                return NULL;
             }
+            return RADIX_TYPES + i;
         }
     }
+    return NULL;
+}
 
-    if(start < right) {
-        vector_qsort_helper(this, start, right, desc);
+static inline uint64_t radix_load(const unsigned char *source, size_t width) {
+    switch (width) {
+        case 1:
+            return *source;
+        case 2: {
+            uint16_t value;
+            memcpy(&value, source, 2);
+            return value;
+        }
+        case 4: {
+            uint32_t value;
+            memcpy(&value, source, 4);
+            return value;
+        }
+        default: {
+            uint64_t value;
+            memcpy(&value, source, 8);
+            return value;
+        }
     }
-    if(left < end) {
-        vector_qsort_helper(this, left, end, desc);
+}
+
+static inline void radix_store(unsigned char *destination, uint64_t value, size_t width) {
+    switch (width) {
+        case 1:
+            *destination = (unsigned char)value;
+            break;
+        case 2: {
+            uint16_t narrow = (uint16_t)value;
+            memcpy(destination, &narrow, 2);
+            break;
+        }
+        case 4: {
+            uint32_t narrow = (uint32_t)value;
+            memcpy(destination, &narrow, 4);
+            break;
+        }
+        default:
+            memcpy(destination, &value, 8);
+            break;
     }
 }
 
-void vector_qsort(Vector *this, bool desc) {
+// Maps the bits of a value of the type to a key whose unsigned order is the order of the values
+static inline uint64_t radix_encode(const RadixType *type, uint64_t bits, bool descending) {
+    uint64_t mask = type->width == 8 ? UINT64_MAX : (UINT64_C(1) << (8 * type->width)) - 1;
+    uint64_t sign = UINT64_C(1) << (8 * type->width - 1);
+    if (type->kind == RADIX_SIGNED) {
+        bits ^= sign;
+    } else if (type->kind == RADIX_FLOAT) {
+        bits = (bits & sign) ? ~bits & mask : bits | sign;
+    }
+    return descending ? ~bits & mask : bits;
+}
+
+// -0.0 and 0.0 compare equal, so a stable sort must key them alike. Only applied where no key is decoded back.
+static inline uint64_t radix_canonical(const RadixType *type, uint64_t bits) {
+    return type->kind == RADIX_FLOAT && bits == UINT64_C(1) << (8 * type->width - 1) ? 0 : bits;
+}
+
+static inline uint64_t radix_decode(const RadixType *type, uint64_t key, bool descending) {
+    uint64_t mask = type->width == 8 ? UINT64_MAX : (UINT64_C(1) << (8 * type->width)) - 1;
+    uint64_t sign = UINT64_C(1) << (8 * type->width - 1);
+    if (descending) {
+        key = ~key & mask;
+    }
+    if (type->kind == RADIX_SIGNED) {
+        key ^= sign;
+    } else if (type->kind == RADIX_FLOAT) {
+        key = (key & sign) ? key ^ sign : ~key & mask;
+    }
+    return key;
+}
+
+// One pass moving every key of the given width to the next free place of its bucket
+#define RADIX_SCATTER(key_type, source, destination, count, digit, digit_counts)        \
+    do {                                                                                \
+        for (size_t _i = 0; _i < (count); _i++) {                                       \
+            key_type _key;                                                              \
+            memcpy(&_key, (source) + _i * sizeof(key_type), sizeof(key_type));          \
+            size_t _pos = (digit_counts)[(_key >> (8 * (digit))) & 0xFF]++;             \
+            memcpy((destination) + _pos * sizeof(key_type), &_key, sizeof(key_type));   \
+        }                                                                               \
+    } while (0)
+
+// Sorts the keys of a sized numeric vector in place, width bytes each, through a buffer of the same size.
+// Every byte is counted in one pass, bytes where all keys agree are then skipped.
+static void radix_sort_keys(unsigned char *keys, unsigned char *buffer, size_t count, size_t width) {
+    size_t counts[8][RADIX_BUCKETS] = {{0}};
+    for (size_t i = 0; i < count; i++) {
+        uint64_t key = radix_load(keys + i * width, width);
+        for (size_t digit = 0; digit < width; digit++) {
+            counts[digit][(key >> (8 * digit)) & 0xFF]++;
+        }
+    }
+
+    unsigned char *source = keys;
+    unsigned char *destination = buffer;
+    uint64_t first_key = radix_load(keys, width);
+    for (size_t digit = 0; digit < width; digit++) {
+        size_t *digit_counts = counts[digit];
+        if (digit_counts[(first_key >> (8 * digit)) & 0xFF] == count) {
+            continue;
+        }
+        size_t offset = 0;
+        for (size_t bucket = 0; bucket < RADIX_BUCKETS; bucket++) {
+            size_t bucket_count = digit_counts[bucket];
+            digit_counts[bucket] = offset;
+            offset += bucket_count;
+        }
+        switch (width) {
+            case 1:
+                RADIX_SCATTER(uint8_t, source, destination, count, digit, digit_counts);
+                break;
+            case 2:
+                RADIX_SCATTER(uint16_t, source, destination, count, digit, digit_counts);
+                break;
+            case 4:
+                RADIX_SCATTER(uint32_t, source, destination, count, digit, digit_counts);
+                break;
+            default:
+                RADIX_SCATTER(uint64_t, source, destination, count, digit, digit_counts);
+                break;
+        }
+        unsigned char *swap = source;
+        source = destination;
+        destination = swap;
+    }
+    if (source != keys) {
+        memcpy(keys, source, count * width);
+    }
+}
+
+// Sorts items by key through a buffer of the same size, returns whichever of the two holds the result
+static RadixItem *radix_sort_items(RadixItem *items, RadixItem *buffer, size_t count) {
+    size_t counts[8][RADIX_BUCKETS] = {{0}};
+    for (size_t i = 0; i < count; i++) {
+        uint64_t key = items[i].key;
+        for (size_t digit = 0; digit < 8; digit++) {
+            counts[digit][(key >> (8 * digit)) & 0xFF]++;
+        }
+    }
+
+    RadixItem *source = items;
+    RadixItem *destination = buffer;
+    for (size_t digit = 0; digit < 8; digit++) {
+        size_t *digit_counts = counts[digit];
+        if (digit_counts[(items[0].key >> (8 * digit)) & 0xFF] == count) {
+            continue;
+        }
+        size_t offset = 0;
+        for (size_t bucket = 0; bucket < RADIX_BUCKETS; bucket++) {
+            size_t bucket_count = digit_counts[bucket];
+            digit_counts[bucket] = offset;
+            offset += bucket_count;
+        }
+        for (size_t i = 0; i < count; i++) {
+            destination[digit_counts[(source[i].key >> (8 * digit)) & 0xFF]++] = source[i];
+        }
+        RadixItem *swap = source;
+        source = destination;
+        destination = swap;
+    }
+    return source;
+}
+
+// Sorts the elements by the keys already in items, then moves the elements into that order.
+// False when the buffers could not be allocated, the vector is then untouched.
+static bool radix_sort_by_items(Vector *this, RadixItem *items) {
+    size_t count = this->size;
+    RadixItem *buffer = malloc(count * sizeof(RadixItem));
+    if (buffer == NULL) {
+        return false;
+    }
+    RadixItem *sorted = radix_sort_items(items, buffer, count);
+    if (!VECTOR_SIZED(this)) {
+        for (size_t i = 0; i < count; i++) {
+            this->nodes[i] = (VectorNode)sorted[i].payload;
+        }
+        free(buffer);
+        return true;
+    }
+    unsigned char *elements = malloc(count * this->element_size);
+    if (elements == NULL) {
+        free(buffer);
+        return false;
+    }
+    for (size_t i = 0; i < count; i++) {
+        memcpy(elements + i * this->element_size, VECTOR_ELEMENT(this, sorted[i].payload), this->element_size);
+    }
+    memcpy(this->nodes, elements, count * this->element_size);
+    free(elements);
+    free(buffer);
+    return true;
+}
+
+// False when the type is not a built-in numeric one or memory ran out, the vector is then untouched
+static bool vector_radix_sort_numeric(Vector *this, bool descending, bool stable) {
+    const RadixType *type = radix_type(this);
+    if (type == NULL) {
+        return false;
+    }
+    size_t count = this->size;
+    // Keys encoded in place are decoded back, so they keep -0.0 apart from 0.0. A stable floating point sort
+    // sorts canonical keys with positions instead.
+    if (VECTOR_SIZED(this) && !(stable && type->kind == RADIX_FLOAT)) {
+        // The elements are their own keys, they are encoded in place and decoded once sorted
+        unsigned char *buffer = malloc(count * type->width);
+        if (buffer == NULL) {
+            return false;
+        }
+        unsigned char *keys = (unsigned char *)this->nodes;
+        for (size_t i = 0; i < count; i++) {
+            radix_store(keys + i * type->width, radix_encode(type, radix_load(keys + i * type->width, type->width), descending), type->width);
+        }
+        radix_sort_keys(keys, buffer, count, type->width);
+        for (size_t i = 0; i < count; i++) {
+            radix_store(keys + i * type->width, radix_decode(type, radix_load(keys + i * type->width, type->width), descending), type->width);
+        }
+        free(buffer);
+        return true;
+    }
+
+    RadixItem *items = malloc(count * sizeof(RadixItem));
+    if (items == NULL) {
+        return false;
+    }
+    for (size_t i = 0; i < count; i++) {
+        unsigned char *element = VECTOR_SIZED(this) ? VECTOR_ELEMENT(this, i) : this->nodes[i];
+        items[i].key = radix_encode(type, radix_canonical(type, radix_load(element, type->width)), descending);
+        items[i].payload = VECTOR_SIZED(this) ? i : (uintptr_t)this->nodes[i];
+    }
+    bool sorted = radix_sort_by_items(this, items);
+    free(items);
+    return sorted;
+}
+
+// Stable, for vectors of the built-in numeric types. Other types are sorted with vector_stable_sort.
+void vector_radix_sort(Vector *this, bool descending) {
+    if (this->size < 2) {
+        return;
+    }
+    if (!vector_radix_sort_numeric(this, descending, true)) {
+        vector_stable_sort(this, descending);
+    }
+}
+
+// Stable, orders the elements by the unsigned key that key computes for each, see the radix_key helpers.
+// Falls back to vector_stable_sort if memory runs out.
+void vector_radix_sort_by(Vector *this, radix_key_function key, bool descending) {
+    if (this->size < 2) {
+        return;
+    }
+    RadixItem *items = malloc(this->size * sizeof(RadixItem));
+    if (items == NULL) {
+        vector_stable_sort(this, descending);
+        return;
+    }
+    for (size_t i = 0; i < this->size; i++) {
+        if (VECTOR_SIZED(this)) {
+            items[i].key = key(VECTOR_ELEMENT(this, i));
+            items[i].payload = i;
+        } else {
+            items[i].key = key(this->nodes[i]);
+            items[i].payload = (uintptr_t)this->nodes[i];
+        }
+        items[i].key = descending ? ~items[i].key : items[i].key;
+    }
+    if (!radix_sort_by_items(this, items)) {
+        vector_stable_sort(this, descending);
+    }
+    free(items);
+}
+
+// Unstable, O(n log n) worst case, linear on sorted, reversed and all equal input.
+// Large vectors of the built-in numeric types are radix sorted instead.
+void vector_sort(Vector *this, bool descending) {
+    if (this->size < 2) {
+        return;
+    }
+    if (this->size >= RADIX_SORT_THRESHOLD && vector_radix_sort_numeric(this, descending, false)) {
+        return;
+    }
+    _Alignas(max_align_t) unsigned char scratch[SORT_SCRATCH_SIZE];
+    VectorSort sort;
+    unsigned char *begin = (unsigned char *)this->nodes;
+    if (!vector_sort_init(&sort, this, descending, scratch)) {
+        sort_heapsort(&sort, begin, begin + this->size * sort.stride);
+        return;
+    }
+    int bad_allowed = 0;
+    for (size_t size = this->size; size > 1; size >>= 1) {
+        bad_allowed++;
+    }
+    sort_pdqsort(&sort, begin, begin + this->size * sort.stride, bad_allowed, true);
+    vector_sort_release(&sort, scratch);
+}
+
+// Stable merge sort, needs room for half the elements. Without it the vector is insertion sorted in place.
+void vector_stable_sort(Vector *this, bool descending) {
     if (this->size < 2) {
         return;
     }
-}
\ No newline at end of file
+    if (this->size >= RADIX_SORT_THRESHOLD && vector_radix_sort_numeric(this, descending, true)) {
+        return;
+    }
+    _Alignas(max_align_t) unsigned char scratch[SORT_SCRATCH_SIZE];
+    VectorSort sort;
+    bool initialized = vector_sort_init(&sort, this, descending, scratch);
+    unsigned char *begin = (unsigned char *)this->nodes;
+    unsigned char *end = begin + this->size * sort.stride;
+    if (!initialized) {
+        sort_insertion_by_swaps(&sort, begin, end);
+        return;
+    }
+    if (sort_reverse_descending(&sort, begin, end)) {
+        vector_sort_release(&sort, scratch);
+        return;
+    }
+    unsigned char *buffer = malloc((this->size / 2 + 1) * sort.stride);
+    if (buffer == NULL) {
+        sort_insertion(&sort, begin, end);
+    } else {
+        sort_merge_sort(&sort, begin, end, buffer);
+        free(buffer);
+    }
+    vector_sort_release(&sort, scratch);
+}
+
+// Kept for existing callers, sorts with vector_sort
+void vector_qsort(Vector *this, bool descending) {
+    vector_sort(this, descending);
+}
+
+// Parallel sorting splits the vector into one chunk per thread, sorts the chunks with vector_sort, then merges
+// neighbouring runs in rounds. Each merge is cut into equal pieces of output by a binary search for where the
+// piece starts in both runs, so the last rounds keep every thread busy too.
+
+// Below this many elements vector_sort_parallel sorts on the calling thread
+#define PARALLEL_SORT_THRESHOLD (1 << 16)
+// Thread counts above this are capped
+#define PARALLEL_SORT_MAX_THREADS 64
+
+typedef struct {
+    Vector *vector;
+    VectorSort *sort;
+    unsigned char *source;
+    unsigned char *destination;
+    size_t begin;       // The chunk to sort, or the left run [begin, middle) and the right run [middle, end)
+    size_t middle;
+    size_t end;
+    size_t out_begin;   // The part of [begin, end) of destination this job writes
+    size_t out_end;
+} ParallelSortJob;
+
+typedef struct {
+    ParallelSortJob *jobs;
+    size_t job_count;
+    size_t first;
+    size_t step;
+    void (*run)(ParallelSortJob *job);
+} ParallelSortWorker;
+
+static void *parallel_sort_worker(void *arg) {
+    ParallelSortWorker *worker = arg;
+    for (size_t i = worker->first; i < worker->job_count; i += worker->step) {
+        worker->run(worker->jobs + i);
+    }
+    return NULL;
+}
+
+// Runs every job across thread_count threads, the calling thread being one of them.
+// Jobs of threads that could not be started run on the calling thread.
+static void parallel_sort_run(ParallelSortJob *jobs, size_t job_count, size_t thread_count, void (*run)(ParallelSortJob *job)) {
+    size_t worker_count = thread_count < job_count ? thread_count : job_count;
+    pthread_t threads[worker_count];
+    ParallelSortWorker workers[worker_count];
+    bool started[worker_count];
+    for (size_t i = 0; i < worker_count; i++) {
+        workers[i] = (ParallelSortWorker){jobs, job_count, i, worker_count, run};
+        started[i] = i > 0 && pthread_create(&threads[i], NULL, parallel_sort_worker, &workers[i]) == 0;
+    }
+    for (size_t i = 0; i < worker_count; i++) {
+        if (!started[i]) {
+            parallel_sort_worker(&workers[i]);
+        }
+    }
+    for (size_t i = 1; i < worker_count; i++) {
+        if (started[i]) {
+            pthread_join(threads[i], NULL);
+        }
+    }
+}
+
+static void parallel_sort_chunk(ParallelSortJob *job) {
+    Vector chunk = vector_slice(job->vector, job->begin, job->end - job->begin);
+    vector_sort(&chunk, job->sort->descending);
+}
+
+// Elements the first rank elements of the merged runs take from the left run, ties go to the left run
+static size_t parallel_sort_split(VectorSort *sort, unsigned char *left, size_t left_size, unsigned char *right, size_t right_size, size_t rank) {
+    size_t stride = sort->stride;
+    size_t low = rank > right_size ? rank - right_size : 0;
+    size_t high = rank < left_size ? rank : left_size;
+    while (low < high) {
+        size_t taken = low + (high - low) / 2;
+        // Left element taken comes out before right element rank - taken - 1, more must come from the left
+        if (!sort_less(sort, right + (rank - taken - 1) * stride, left + taken * stride)) {
+            low = taken + 1;
+        } else {
+            high = taken;
+        }
+    }
+    return low;
+}
+
+static void parallel_sort_merge(ParallelSortJob *job) {
+    VectorSort *sort = job->sort;
+    size_t stride = sort->stride;
+    unsigned char *left = job->source + job->begin * stride;
+    unsigned char *right = job->source + job->middle * stride;
+    size_t left_size = job->middle - job->begin;
+    size_t right_size = job->end - job->middle;
+
+    size_t left_first = parallel_sort_split(sort, left, left_size, right, right_size, job->out_begin - job->begin);
+    size_t left_last = parallel_sort_split(sort, left, left_size, right, right_size, job->out_end - job->begin);
+    unsigned char *left_at = left + left_first * stride;
+    unsigned char *left_end = left + left_last * stride;
+    unsigned char *right_at = right + (job->out_begin - job->begin - left_first) * stride;
+    unsigned char *right_end = right + (job->out_end - job->begin - left_last) * stride;
+    unsigned char *out = job->destination + job->out_begin * stride;
+
+    while (left_at < left_end && right_at < right_end) {
+        if (sort_less(sort, right_at, left_at)) {
+            sort_move(sort, out, right_at);
+            right_at += stride;
+        } else {
+            sort_move(sort, out, left_at);
+            left_at += stride;
+        }
+        out += stride;
+    }
+    memcpy(out, left_at, (size_t)(left_end - left_at));
+    out += left_end - left_at;
+    memcpy(out, right_at, (size_t)(right_end - right_at));
+}
+
+// Unstable like vector_sort, sorts on up to thread_count threads. Chunks of types vector_sort radix sorts are
+// radix sorted. Small vectors, a single thread or running out of memory sort on the calling thread.
+void vector_sort_parallel(Vector *this, bool descending, size_t thread_count) {
+    if (this->size < PARALLEL_SORT_THRESHOLD || thread_count < 2) {
+        vector_sort(this, descending);
+        return;
+    }
+    if (thread_count > PARALLEL_SORT_MAX_THREADS) {
+        thread_count = PARALLEL_SORT_MAX_THREADS;
+    }
+    VectorSort sort;
+    vector_sort_layout(&sort, this, descending);
+    size_t count = this->size;
+    size_t chunk_count = thread_count;
+    unsigned char *buffer = malloc(count * sort.stride);
+    size_t *bounds = malloc((chunk_count + 1) * sizeof(size_t));
+    ParallelSortJob *jobs = malloc(2 * thread_count * sizeof(ParallelSortJob));
+    if (buffer == NULL || bounds == NULL || jobs == NULL) {
+        free(buffer);
+        free(bounds);
+        free(jobs);
+        vector_sort(this, descending);
+        return;
+    }
+
+    for (size_t i = 0; i <= chunk_count; i++) {
+        bounds[i] = count / chunk_count * i + (i < count % chunk_count ? i : count % chunk_count);
+    }
+    for (size_t i = 0; i < chunk_count; i++) {
+        jobs[i] = (ParallelSortJob){.vector = this, .sort = &sort, .begin = bounds[i], .end = bounds[i + 1]};
+    }
+    parallel_sort_run(jobs, chunk_count, thread_count, parallel_sort_chunk);
+
+    unsigned char *source = (unsigned char *)this->nodes;
+    unsigned char *destination = buffer;
+    size_t run_count = chunk_count;
+    while (run_count > 1) {
+        size_t job_count = 0;
+        size_t pair_count = (run_count + 1) / 2;
+        size_t pieces = thread_count / pair_count > 1 ? thread_count / pair_count : 1;
+        for (size_t pair = 0; pair < pair_count; pair++) {
+            size_t begin = bounds[2 * pair];
+            size_t middle = bounds[2 * pair + 1];
+            size_t end = 2 * pair + 2 <= run_count ? bounds[2 * pair + 2] : middle;
+            // A run without a partner is copied across as one piece
+            size_t pair_pieces = end > middle ? pieces : 1;
+            for (size_t piece = 0; piece < pair_pieces; piece++) {
+                jobs[job_count++] = (ParallelSortJob){
+                    .sort = &sort,
+                    .source = source,
+                    .destination = destination,
+                    .begin = begin,
+                    .middle = middle,
+                    .end = end,
+                    .out_begin = begin + (end - begin) * piece / pair_pieces,
+                    .out_end = begin + (end - begin) * (piece + 1) / pair_pieces,
+                };
+            }
+            bounds[pair] = begin;
+        }
+        bounds[pair_count] = count;
+        parallel_sort_run(jobs, job_count, thread_count, parallel_sort_merge);
+        unsigned char *swap = source;
+        source = destination;
+        destination = swap;
+        run_count = pair_count;
+    }
+
+    if (source != (unsigned char *)this->nodes) {
+        memcpy(this->nodes, source, count * sort.stride);
+    }
+    free(buffer);
+    free(bounds);
+    free(jobs);
+}
@@ -0,0 +1,165 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "bloomfilter.h"
+#include "hashmap.h"
+#include "treeset.h"
+#include "typemethods.h"
+#include "testtools.h"
+
+static type_methods TYPE_INT = TYPE_METHODS(int);
+
+// Counts comparisons, which only happen once a lookup got past the filter
+static size_t comparisons = 0;
+
+static int counting_int_comparator(void *first, void *second) {
+    comparisons++;
+    return int_comparator(first, second);
+}
+
+static type_methods TYPE_COUNTED_INT = {
+    .crt = int_default_constructor,
+    .del = int_destructor,
+    .dup = int_copy_constructor,
+    .cmp = counting_int_comparator,
+    .hash = int_hash_function,
+};
+
+// Fraction of the ints from first up to first + count the filter claims to contain
+static double positive_rate(BloomFilter *filter, int first, int count) {
+    size_t positives = 0;
+    for (int i = first; i < first + count; i++) {
+        positives += bloomfilter_contains(filter, &i);
+    }
+    return (double)positives / count;
+}
+
+void test_bloomfilter_rates() {
+    printf("Testing Bloom filter false positive rates...\n");
+    const double rates[] = {0.1, 0.01, 0.001};
+    for (size_t r = 0; r < sizeof(rates) / sizeof(rates[0]); r++) {
+        BloomFilter *filter = bloomfilter_create(&TYPE_INT, 100000, rates[r]);
+        for (int i = 0; i < 100000; i++) {
+            bloomfilter_add(filter, &i);
+        }
+        checkf(positive_rate(filter, 0, 100000) == 1.0, "no false negatives at rate %g", rates[r]);
+
+        double measured = positive_rate(filter, 1000000, 200000);
+        printf("  target %g : measured %.5f, estimated %.5f, %zu hashes, %.1f bits per element\n", rates[r], measured,
+               bloomfilter_estimated_false_positive_rate(filter), bloomfilter_hash_count(filter),
+               (double)bloomfilter_bit_count(filter) / 100000);
+        checkf(measured < rates[r] * 1.5, "false positive rate near %g", rates[r]);
+        bloomfilter_destroy(filter);
+    }
+
+    BloomFilter *filter = bloomfilter_create(&TYPE_INT, 10, 0.01);
+    check(bloomfilter_create(&TYPE_INT, 10, 0) == NULL && bloomfilter_create(&TYPE_INT, 10, 1) == NULL, "rates outside (0, 1) are refused");
+    bloomfilter_add(filter, &(int){5});
+    BloomFilter *clone = bloomfilter_clone(filter);
+    bloomfilter_clear(filter);
+    check(!bloomfilter_contains(filter, &(int){5}) && bloomfilter_size(filter) == 0, "clear forgets every element");
+    check(bloomfilter_contains(clone, &(int){5}), "clones keep their own bits");
+    bloomfilter_destroy(filter);
+    bloomfilter_destroy(clone);
+}
+
+void test_bloomfilter_hashmap() {
+    printf("Testing Bloom filters attached to HashMaps...\n");
+    HashMap *migrating = hashmap_create(&TYPE_COUNTED_INT, &TYPE_INT);
+    hashmap_set_migration_budget(migrating, 4);
+    HashMap *maps[] = {
+        hashmap_create(&TYPE_COUNTED_INT, &TYPE_INT),
+        hashmap_create_with_probe(&TYPE_COUNTED_INT, &TYPE_INT, HASHMAP_PROBE_ROBIN_HOOD),
+        hashmap_create_dense(&TYPE_COUNTED_INT, &TYPE_INT),
+        hashmap_create_inline(&TYPE_COUNTED_INT, sizeof(int), sizeof(int)),
+        migrating,
+    };
+    const char *names[] = {"triangular", "robin hood", "dense", "inline", "migrating"};
+    for (size_t m = 0; m < sizeof(maps) / sizeof(maps[0]); m++) {
+        HashMap *map = maps[m];
+        const char *name = names[m];
+        hashmap_attach_filter(map, 0.01);
+        for (int i = 0; i < 20000; i++) {
+            hashmap_set(map, &i, &i);
+        }
+        for (int i = 0; i < 20000; i += 2) {
+            hashmap_remove(map, &i);
+        }
+
+        bool found = true;
+        for (int i = 1; i < 20000; i += 2) {
+            found = found && hashmap_contains(map, &i) && *(int *)hashmap_get(map, &i) == i;
+        }
+        checkf(found, "%s map finds every key through the filter", name);
+
+        bool missed = true;
+        comparisons = 0;
+        for (int i = 0; i < 20000; i += 2) {
+            missed = missed && !hashmap_contains(map, &i);
+        }
+        for (int i = 100000; i < 200000; i++) {
+            missed = missed && !hashmap_contains(map, &i);
+        }
+        checkf(missed, "%s map misses removed and absent keys", name);
+        // Removed keys stay in the filter, the 100000 never inserted should mostly stop at it
+        checkf(comparisons < 10000 + 3000, "%s map turns most misses away before comparing", name);
+
+        hashmap_reseed(map, 12345);
+        found = true;
+        for (int i = 1; i < 20000; i += 2) {
+            found = found && hashmap_contains(map, &i);
+        }
+        checkf(found, "%s map keeps the filter in step with a reseed", name);
+
+        HashMap *clone = hashmap_clone(map, &TYPE_INT);
+        checkf(clone->filter != NULL && clone->filter != map->filter && hashmap_contains(clone, &(int){19999}),
+               "%s map clones carry the filter", name);
+        hashmap_destroy(clone);
+
+        hashmap_clear(map);
+        hashmap_set(map, &(int){7}, &(int){7});
+        checkf(hashmap_contains(map, &(int){7}) && !hashmap_contains(map, &(int){9}), "%s map filters after clear", name);
+
+        hashmap_detach_filter(map);
+        checkf(map->filter == NULL && hashmap_contains(map, &(int){7}), "%s map works once the filter is detached", name);
+        hashmap_destroy(map);
+    }
+}
+
+void test_bloomfilter_treeset() {
+    printf("Testing Bloom filters attached to TreeSets...\n");
+    TreeSet *set = treeset_create(&TYPE_COUNTED_INT);
+    for (int i = 0; i < 100; i++) {
+        treeset_add(set, &i);
+    }
+    treeset_attach_filter(set, 0.01);
+    for (int i = 100; i < 5000; i++) {
+        treeset_add(set, &i);
+    }
+
+    bool found = true;
+    for (int i = 0; i < 5000; i++) {
+        found = found && treeset_contains(set, &i) && *(int *)treeset_get_key(set, &i) == i;
+    }
+    check(found, "the set finds every element through the filter");
+
+    comparisons = 0;
+    bool missed = true;
+    for (int i = 10000; i < 20000; i++) {
+        missed = missed && !treeset_contains(set, &i) && treeset_get_key(set, &i) == NULL;
+    }
+    check(missed, "the set misses absent elements");
+    check(comparisons < 20000 * 13 / 20, "most misses never walk the tree");
+
+    treeset_detach_filter(set);
+    check(set->filter == NULL && treeset_contains(set, &(int){42}), "the set works once the filter is detached");
+    treeset_destroy(set);
+}
+
+int main() {
+    test_bloomfilter_rates();
+    test_bloomfilter_hashmap();
+    test_bloomfilter_treeset();
+    return check_summary("Bloom filter");
+}
@@ -0,0 +1,113 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "concurrenthashmap.h"
+#include "typemethods.h"
+#include "testtools.h"
+
+static type_methods TYPE_INT = TYPE_METHODS(int);
+
+static const int THREAD_COUNT = 8;
+static const int KEYS_PER_THREAD = 20000;
+
+typedef struct {
+    ConcurrentHashMap *map;
+    int thread;
+    bool ok;
+} worker_args;
+
+// Each writer owns a range of keys, so it can check its own entries while the others write
+static void *writer(void *arg) {
+    worker_args *args = arg;
+    int first = args->thread * KEYS_PER_THREAD;
+    args->ok = true;
+    for (int key = first; key < first + KEYS_PER_THREAD; key++) {
+        int value = key * 2;
+        concurrenthashmap_set(args->map, &key, &value);
+    }
+    for (int key = first; key < first + KEYS_PER_THREAD; key++) {
+        int *value = concurrenthashmap_get(args->map, &key);
+        if (value == NULL || *value != key * 2) {
+            args->ok = false;
+        }
+        int_destructor(value);
+        if (key % 2 == 0) {
+            concurrenthashmap_remove(args->map, &key);
+        }
+    }
+    return NULL;
+}
+
+// Readers only ever see a key missing or with its final value
+static void *reader(void *arg) {
+    worker_args *args = arg;
+    args->ok = true;
+    for (int round = 0; round < 4; round++) {
+        for (int key = 1; key < THREAD_COUNT * KEYS_PER_THREAD; key += 2) {
+            int *value = concurrenthashmap_get(args->map, &key);
+            if (value != NULL && *value != key * 2) {
+                args->ok = false;
+            }
+            int_destructor(value);
+        }
+        size_t size = concurrenthashmap_size(args->map);
+        if (size > (size_t)(THREAD_COUNT * KEYS_PER_THREAD)) {
+            args->ok = false;
+        }
+    }
+    return NULL;
+}
+
+void test_concurrenthashmap_threads() {
+    printf("Testing ConcurrentHashMap with concurrent writers and readers...\n");
+    ConcurrentHashMap *map = concurrenthashmap_create(&TYPE_INT, &TYPE_INT, 0);
+
+    pthread_t threads[2 * THREAD_COUNT];
+    worker_args args[2 * THREAD_COUNT];
+    for (int i = 0; i < 2 * THREAD_COUNT; i++) {
+        args[i] = (worker_args){.map = map, .thread = i % THREAD_COUNT, .ok = false};
+        pthread_create(&threads[i], NULL, i < THREAD_COUNT ? writer : reader, &args[i]);
+    }
+    bool all_ok = true;
+    for (int i = 0; i < 2 * THREAD_COUNT; i++) {
+        pthread_join(threads[i], NULL);
+        all_ok = all_ok && args[i].ok;
+    }
+    check(all_ok, "every thread saw consistent values");
+    check(concurrenthashmap_size(map) == (size_t)(THREAD_COUNT * KEYS_PER_THREAD / 2), "size after concurrent removal");
+
+    size_t counted = 0;
+    bool only_odd = true;
+    CONCURRENTHASHMAP_PAIRS_FOREACH(map, int *key, int *value, {
+        counted++;
+        if (*key % 2 == 0 || *value != *key * 2) {
+            only_odd = false;
+        }
+    });
+    check(counted == concurrenthashmap_size(map), "iteration visits every entry once");
+    check(only_odd, "iteration sees only surviving entries");
+
+    concurrenthashmap_destroy(map);
+}
+
+void test_concurrenthashmap_single_shard() {
+    printf("Testing ConcurrentHashMap with a single shard...\n");
+    ConcurrentHashMap *map = concurrenthashmap_create(&TYPE_INT, NULL, 1);
+    for (int i = 0; i < 1000; i++) {
+        concurrenthashmap_add(map, &i);
+    }
+    int missing = 1000;
+    check(map->shard_count == 1, "shard count is kept");
+    check(concurrenthashmap_contains(map, &(int){999}) && !concurrenthashmap_contains(map, &missing), "lookups in a single shard");
+    check(concurrenthashmap_size(map) == 1000, "size of a single shard");
+    concurrenthashmap_destroy(map);
+}
+
+int main() {
+    test_concurrenthashmap_threads();
+    test_concurrenthashmap_single_shard();
+    return check_summary("ConcurrentHashMap");
+}
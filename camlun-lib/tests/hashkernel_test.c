@@ -0,0 +1,176 @@
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "hashkernel.h"
+#include "murmur3.h"
+#include "typemethods.h"
+#include "testtools.h"
+
+// Compares the width specialized kernels with the MurmurHash3 path they replace
+
+static const size_t KEY_COUNT = 3072;
+static const size_t BUCKET_BITS = 12;
+
+static uint64_t murmur_hash(const void *ptr, size_t size) {
+    uint64_t hash_output[2];
+    MurmurHash3_x64_128(ptr, (int)size, HASH_SEED, hash_output);
+    return hash_output[0] ^ hash_output[1];
+}
+
+// Key i of a pattern, written in the first size bytes of key
+static void make_key(unsigned char *key, size_t size, size_t i, int pattern) {
+    uint64_t words[2] = {0, 0};
+    switch (pattern) {
+        case 0: words[0] = i; break;                               // Sequential
+        case 1: words[0] = i << 12; break;                         // Strided, low bits all zero
+        case 2: words[0] = 0x7f0000001000ULL + i * 64; break;      // Aligned addresses
+        case 3: words[0] = 0x7f0000001000ULL + (i / 64) * 48;      // Pairs of addresses like GraphEdgeKey
+                words[1] = 0x7f0000001000ULL + (i % 64) * 48; break;
+    }
+    memcpy(key, words, size);
+}
+
+// Buckets left empty when hashing the pattern into a table of 1 << BUCKET_BITS slots
+// by the bits HashMap probes with, distinct reports whether every key got its own hash
+static size_t empty_buckets(size_t size, int pattern, bool kernel, bool *distinct) {
+    size_t bucket_count = (size_t)1 << BUCKET_BITS;
+    bool *used = calloc(bucket_count, sizeof(bool));
+    uint64_t *hashes = malloc(KEY_COUNT * sizeof(uint64_t));
+    unsigned char key[HASH_KERNEL_MAX_SIZE];
+    for (size_t i = 0; i < KEY_COUNT; i++) {
+        make_key(key, size, i, pattern);
+        hashes[i] = kernel ? numerical_hash_function(size, key) : murmur_hash(key, size);
+        used[(hashes[i] >> 7) & (bucket_count - 1)] = true;
+    }
+    *distinct = true;
+    for (size_t i = 0; i < KEY_COUNT && *distinct; i++) {
+        for (size_t j = i + 1; j < KEY_COUNT; j++) {
+            if (hashes[i] == hashes[j]) {
+                *distinct = false;
+                break;
+            }
+        }
+    }
+    size_t empty = 0;
+    for (size_t i = 0; i < bucket_count; i++) {
+        empty += !used[i];
+    }
+    free(used);
+    free(hashes);
+    return empty;
+}
+
+void test_hashkernel_buckets() {
+    printf("Testing hash kernel bucket spread against MurmurHash3...\n");
+    const size_t sizes[] = {2, 4, 8, 16};
+    for (int pattern = 0; pattern < 4; pattern++) {
+        for (size_t s = 0; s < sizeof(sizes) / sizeof(sizes[0]); s++) {
+            size_t size = sizes[s];
+            if ((pattern >= 2 && size < 8) || (pattern == 3 && size < 16) || (pattern == 1 && size < 4)) {
+                continue;
+            }
+            bool kernel_distinct, murmur_distinct;
+            size_t kernel_empty = empty_buckets(size, pattern, true, &kernel_distinct);
+            size_t murmur_empty = empty_buckets(size, pattern, false, &murmur_distinct);
+            printf("  %2zu bytes, pattern %d : %zu empty buckets, murmur %zu\n", size, pattern, kernel_empty, murmur_empty);
+            checkf(kernel_distinct, "%zu byte keys of pattern %d get distinct hashes", size, pattern);
+            // Random placement leaves about e^-0.75 of the buckets empty, allow a few percent on top
+            checkf(kernel_empty <= murmur_empty + ((size_t)1 << BUCKET_BITS) / 32,
+                   "%zu byte keys of pattern %d spread like murmur", size, pattern);
+        }
+    }
+}
+
+void test_hashkernel_small_widths() {
+    printf("Testing hash kernels on every 1 and 2 byte key...\n");
+    size_t count = 1 << 16;
+    uint64_t *hashes = malloc(count * sizeof(uint64_t));
+    for (size_t i = 0; i < count; i++) {
+        uint16_t key = (uint16_t)i;
+        hashes[i] = numerical_hash_function(sizeof(key), &key);
+    }
+    // Sorting would need a comparator per width, a bitmap over the top 24 bits is enough here
+    size_t bitmap_bits = (size_t)1 << 24;
+    unsigned char *seen = calloc(bitmap_bits / 8, 1);
+    size_t repeats = 0;
+    for (size_t i = 0; i < count; i++) {
+        size_t bit = hashes[i] >> 40;
+        repeats += (seen[bit / 8] >> (bit % 8)) & 1;
+        seen[bit / 8] |= 1 << (bit % 8);
+    }
+    // 65536 keys in 2^24 slots repeat about 128 times when the hash is uniform
+    check(repeats < 256, "2 byte keys spread over the high bits");
+
+    bool distinct = true;
+    uint64_t byte_hashes[256];
+    for (int i = 0; i < 256; i++) {
+        unsigned char key = (unsigned char)i;
+        byte_hashes[i] = numerical_hash_function(1, &key);
+        for (int j = 0; j < i; j++) {
+            distinct = distinct && byte_hashes[i] != byte_hashes[j];
+        }
+    }
+    check(distinct, "every 1 byte key gets its own hash");
+    free(seen);
+    free(hashes);
+}
+
+void test_hashkernel_avalanche() {
+    printf("Testing hash kernel avalanche...\n");
+    uint64_t state = 0x9E3779B97F4A7C15ULL;
+    size_t flips[64] = {0};
+    size_t samples = 0;
+    for (int round = 0; round < 1000; round++) {
+        state = state * 6364136223846793005ULL + 1442695040888963407ULL;
+        uint64_t key = state;
+        uint64_t hash = numerical_hash_function(sizeof(key), &key);
+        for (int bit = 0; bit < 64; bit++) {
+            uint64_t flipped = key ^ ((uint64_t)1 << bit);
+            uint64_t difference = hash ^ numerical_hash_function(sizeof(flipped), &flipped);
+            for (int out = 0; out < 64; out++) {
+                flips[out] += (difference >> out) & 1;
+            }
+            samples++;
+        }
+    }
+    double worst = 0;
+    for (int out = 0; out < 64; out++) {
+        double bias = (double)flips[out] / samples - 0.5;
+        worst = bias < 0 ? (-bias > worst ? -bias : worst) : (bias > worst ? bias : worst);
+    }
+    printf("  worst output bit bias %.4f\n", worst);
+    check(worst < 0.05, "every output bit flips about half the time when one input bit flips");
+}
+
+void test_hashkernel_seeded() {
+    printf("Testing seeded hashes...\n");
+    int key = 12345;
+    check(int_seeded_hash_function(&key, 1) == int_seeded_hash_function(&key, 1), "seeded hashes are deterministic");
+    check(int_seeded_hash_function(&key, 1) != int_seeded_hash_function(&key, 2), "the seed changes the hash");
+    check(string_seeded_hash_function("short", 1) != string_seeded_hash_function("short", 2), "the seed changes short string hashes");
+    check(string_seeded_hash_function("a string longer than sixteen bytes", 1) != string_seeded_hash_function("a string longer than sixteen bytes", 2),
+          "the seed changes long string hashes");
+
+    // Strings starting with the bytes of HASH_KERNEL_P1 cancel the kernel's first multiplicand
+    char first[16], second[16];
+    memcpy(first, &HASH_KERNEL_P1, 8);
+    memcpy(second, &HASH_KERNEL_P1, 8);
+    strcpy(first + 8, "abc");
+    strcpy(second + 8, "xyz");
+    check(string_seeded_hash_function(first, 1) != string_seeded_hash_function(second, 1) ||
+          string_seeded_hash_function(first, 2) != string_seeded_hash_function(second, 2),
+          "no prefix makes seeded string hashes collide under every seed");
+    check(string_seeded_hash_function(first, 1) != string_seeded_hash_function(first, 2),
+          "the seed changes the hash of a prefix that cancels the kernel");
+    check(int_hash_function(&key) == numerical_hash_function(sizeof(int), &key), "inlined and dispatched kernels agree");
+}
+
+int main() {
+    test_hashkernel_buckets();
+    test_hashkernel_small_widths();
+    test_hashkernel_avalanche();
+    test_hashkernel_seeded();
+    return check_summary("hash kernel");
+}
@@ -1,7 +1,579 @@
 #include "hashmap.h"
+#include "testtools.h"
 #include <stdlib.h>
 #include <stdio.h>
 
+static type_methods TYPE_INT = TYPE_METHODS(int);
+
+static size_t hash_calls = 0;
+static size_t compare_calls = 0;
+
+static size_t counting_int_hash_function(void *ptr) {
+    hash_calls++;
+    return int_hash_function(ptr);
+}
+
+static int counting_int_comparator(void *first, void *second) {
+    compare_calls++;
+    return int_comparator(first, second);
+}
+
+static type_methods TYPE_COUNTING_INT = {
+    .crt = int_default_constructor,
+    .del = int_destructor,
+    .dup = int_copy_constructor,
+    .cmp = counting_int_comparator,
+    .hash = counting_int_hash_function};
+
+// With seed 42 every key lands in the first group, as if an adversary had picked them
+static size_t flooded_int_seeded_hash_function(void *ptr, uint64_t seed) {
+    if (seed == 42) {
+        return (size_t)*(int *)ptr << 40;
+    }
+    return int_seeded_hash_function(ptr, seed);
+}
+
+static type_methods TYPE_FLOODED_INT = {
+    .crt = int_default_constructor,
+    .del = int_destructor,
+    .dup = int_copy_constructor,
+    .cmp = int_comparator,
+    .hash = int_hash_function,
+    .seeded_hash = flooded_int_seeded_hash_function};
+
+static const int STRESS_COUNT = 100000;
+
+static const char *PROBE_NAMES[] = {"triangular", "linear", "robin hood"};
+
+void test_hashmap_stress_insert_lookup(hashmap_probe probe) {
+    printf("Testing HashMap bulk insertion and lookup (%s probing)...\n", PROBE_NAMES[probe]);
+    HashMap *map = hashmap_create_with_probe(&TYPE_INT, &TYPE_INT, probe);
+
+    for (int i = 0; i < STRESS_COUNT; i++) {
+        int value = i * 3;
+        hashmap_set(map, &i, &value);
+    }
+    check(hashmap_size(map) == (size_t)STRESS_COUNT, "size after insertion");
+
+    bool all_found = true;
+    for (int i = 0; i < STRESS_COUNT; i++) {
+        int *value = hashmap_get(map, &i);
+        if (value == NULL || *value != i * 3) {
+            all_found = false;
+        }
+    }
+    check(all_found, "every inserted key is found with its value");
+
+    bool none_found = true;
+    for (int i = STRESS_COUNT; i < 2 * STRESS_COUNT; i++) {
+        if (hashmap_contains(map, &i)) {
+            none_found = false;
+        }
+    }
+    check(none_found, "absent keys are not found");
+
+    hashmap_destroy(map);
+}
+
+void test_hashmap_stress_churn(hashmap_probe probe) {
+    printf("Testing HashMap insert/remove churn (%s probing)...\n", PROBE_NAMES[probe]);
+    HashMap *map = hashmap_create_with_probe(&TYPE_INT, &TYPE_INT, probe);
+
+    for (int round = 0; round < 8; round++) {
+        for (int i = 0; i < STRESS_COUNT / 8; i++) {
+            int key = round * STRESS_COUNT + i;
+            hashmap_set(map, &key, &round);
+        }
+        for (int i = 0; i < STRESS_COUNT / 8; i += 2) {
+            int key = round * STRESS_COUNT + i;
+            hashmap_remove(map, &key);
+        }
+    }
+    check(hashmap_size(map) == (size_t)(8 * (STRESS_COUNT / 16)), "size after churn");
+
+    size_t counted = 0;
+    bool values_match = true;
+    HASHMAP_PAIRS_FOREACH(map, int *key, int *value, {
+        counted++;
+        if (*key / STRESS_COUNT != *value || (*key % STRESS_COUNT) % 2 == 0) {
+            values_match = false;
+        }
+    });
+    check(counted == hashmap_size(map), "iteration visits every live entry once");
+    check(values_match, "iteration sees only surviving entries");
+
+    hashmap_destroy(map);
+}
+
+void test_hashmap_stress_sliding_window(hashmap_probe probe) {
+    printf("Testing HashMap capacity under a sliding window of keys (%s probing)...\n", PROBE_NAMES[probe]);
+    HashMap *map = hashmap_create_with_probe(&TYPE_INT, &TYPE_INT, probe);
+    const int window = 1000;
+
+    bool window_matches = true;
+    for (int i = 0; i < STRESS_COUNT; i++) {
+        hashmap_set(map, &i, &i);
+        if (i >= window) {
+            int expired = i - window;
+            hashmap_remove(map, &expired);
+            if (hashmap_contains(map, &expired) || !hashmap_contains(map, &i)) {
+                window_matches = false;
+            }
+        }
+    }
+    check(window_matches, "expired keys are gone and fresh keys are present");
+    check(hashmap_size(map) == (size_t)window, "size stays at the window");
+    check(hashmap_capacity(map) <= 4 * (size_t)window, "capacity stays bounded by the live entries");
+    if (probe != HASHMAP_PROBE_TRIANGULAR) {
+        check(hashmap_occupied_size(map) == hashmap_size(map), "removal leaves no tombstones");
+    }
+
+    hashmap_destroy(map);
+}
+
+void test_hashmap_stress_dense() {
+    printf("Testing dense HashMap insertion order...\n");
+    HashMap *map = hashmap_create_dense(&TYPE_INT, &TYPE_INT);
+
+    // Keys are inserted in a scrambled order, every third one is removed and the rest reinserted
+    for (int i = 0; i < STRESS_COUNT; i++) {
+        int key = (i * 7919) % STRESS_COUNT;
+        hashmap_set(map, &key, &i);
+    }
+    for (int i = 0; i < STRESS_COUNT; i += 3) {
+        int key = (i * 7919) % STRESS_COUNT;
+        hashmap_remove(map, &key);
+    }
+    for (int i = 0; i < STRESS_COUNT; i += 3) {
+        int key = (i * 7919) % STRESS_COUNT;
+        int order = STRESS_COUNT + i;
+        hashmap_set(map, &key, &order);
+    }
+    check(hashmap_size(map) == (size_t)STRESS_COUNT, "size after reinsertion");
+
+    bool ordered = true;
+    int previous = -1;
+    size_t counted = 0;
+    HASHMAP_PAIRS_FOREACH(map, int *key, int *order, {
+        counted++;
+        if (*order <= previous || (*order % STRESS_COUNT * 7919) % STRESS_COUNT != *key) {
+            ordered = false;
+        }
+        previous = *order;
+    });
+    check(counted == (size_t)STRESS_COUNT, "iteration visits every entry once");
+    check(ordered, "iteration follows insertion order");
+    hashmap_destroy(map);
+
+    HashMap *window = hashmap_create_inline_dense(&TYPE_INT, sizeof(int), sizeof(int));
+    bool window_matches = true;
+    for (int i = 0; i < STRESS_COUNT; i++) {
+        hashmap_set(window, &i, &i);
+        if (i >= 1000) {
+            int expired = i - 1000;
+            hashmap_remove(window, &expired);
+        }
+        if (i % 4096 == 0) {
+            int expected = i < 1000 ? 0 : i - 999;
+            HASHMAP_KEYS_FOREACH(window, int *key, {
+                if (*key != expected++) {
+                    window_matches = false;
+                }
+            });
+        }
+    }
+    check(window_matches, "a sliding window iterates oldest first");
+    check(window->entry_capacity <= 4 * 1000, "removed entries are compacted away");
+    hashmap_destroy(window);
+}
+
+void test_hashmap_stress_hashed_and_batched() {
+    printf("Testing HashMap precomputed hashes and batched lookups...\n");
+    HashMap *names = hashmap_create(&TYPE_INT, &TYPE_INT);
+    HashMap *scores = hashmap_create(&TYPE_INT, &TYPE_INT);
+    // Hashes computed with names are reused for scores, which takes its seed
+    hashmap_reseed(scores, names->seed);
+
+    for (int i = 0; i < STRESS_COUNT; i++) {
+        size_t hash = hashmap_hash(names, &i);
+        hashmap_set_hashed(names, &i, hash, &i);
+        if (i % 3 == 0) {
+            int score = -i;
+            hashmap_set_hashed(scores, &i, hash, &score);
+        }
+    }
+
+    bool hashed_match = true;
+    for (int i = 0; i < STRESS_COUNT; i++) {
+        size_t hash = hashmap_hash(names, &i);
+        int *name = hashmap_get_hashed(names, &i, hash);
+        if (name == NULL || *name != i || hashmap_contains_hashed(scores, &i, hash) != (i % 3 == 0)) {
+            hashed_match = false;
+        }
+        if (i % 3 == 0 && *(int *)hashmap_get(scores, &i) != -i) {
+            hashed_match = false;
+        }
+    }
+    check(hashed_match, "hashes computed once are shared between maps with the same key methods");
+
+    int *ids = malloc(2 * STRESS_COUNT * sizeof(int));
+    void **keys = malloc(2 * STRESS_COUNT * sizeof(void *));
+    void **values = malloc(2 * STRESS_COUNT * sizeof(void *));
+    for (int i = 0; i < 2 * STRESS_COUNT; i++) {
+        ids[i] = (i * 7919) % (2 * STRESS_COUNT);
+        keys[i] = &ids[i];
+    }
+    size_t found = hashmap_get_many(scores, keys, 2 * STRESS_COUNT, values);
+    bool batch_matches = true;
+    size_t expected = 0;
+    for (int i = 0; i < 2 * STRESS_COUNT; i++) {
+        bool present = ids[i] < STRESS_COUNT && ids[i] % 3 == 0;
+        expected += present;
+        if (present ? values[i] == NULL || *(int *)values[i] != -ids[i] : values[i] != NULL) {
+            batch_matches = false;
+        }
+    }
+    check(found == expected, "batched lookup counts the keys found");
+    check(batch_matches, "batched lookup matches single lookups");
+
+    for (int i = 0; i < STRESS_COUNT; i += 3) {
+        hashmap_remove_hashed(scores, &i, hashmap_hash(scores, &i));
+    }
+    check(hashmap_empty(scores), "hashed removal removes every key");
+
+    free(ids);
+    free(keys);
+    free(values);
+    hashmap_destroy(names);
+    hashmap_destroy(scores);
+}
+
+typedef struct {
+    int x;
+    int y;
+} GridPoint;
+
+void test_hashmap_stress_inline(size_t budget) {
+    printf("Testing inline HashMap counters (migration budget %zu)...\n", budget);
+    HashMap *counters = hashmap_create_inline(&TYPE_INT, sizeof(int), sizeof(long));
+    hashmap_set_migration_budget(counters, budget);
+
+    for (int round = 0; round < 3; round++) {
+        for (int i = 0; i < STRESS_COUNT; i++) {
+            int key = i % (STRESS_COUNT / 4);
+            long *count = hashmap_get(counters, &key);
+            if (count == NULL) {
+                long one = 1;
+                hashmap_set(counters, &key, &one);
+            } else {
+                (*count)++;
+            }
+        }
+    }
+    check(hashmap_size(counters) == (size_t)(STRESS_COUNT / 4), "one inline entry per distinct key");
+
+    bool counts_match = true;
+    HASHMAP_PAIRS_FOREACH(counters, int *key, long *count, {
+        if (*key < 0 || *key >= STRESS_COUNT / 4 || *count != 12) {
+            counts_match = false;
+        }
+    });
+    check(counts_match, "counters updated through hashmap_get");
+
+    for (int i = 0; i < STRESS_COUNT / 4; i += 2) {
+        hashmap_remove(counters, &i);
+    }
+    bool survivors_match = true;
+    for (int i = 0; i < STRESS_COUNT / 4; i++) {
+        if (hashmap_contains(counters, &i) != (i % 2 == 1)) {
+            survivors_match = false;
+        }
+    }
+    check(survivors_match, "only odd inline keys remain");
+    hashmap_destroy(counters);
+
+    // Without type methods, inline keys are hashed and compared as bytes
+    HashMap *points = hashmap_create_inline(NULL, sizeof(GridPoint), sizeof(double));
+    hashmap_set_migration_budget(points, budget);
+    for (int i = 0; i < STRESS_COUNT; i++) {
+        GridPoint point = {i % 317, i / 317};
+        double distance = i * 0.5;
+        hashmap_set(points, &point, &distance);
+    }
+    bool points_match = hashmap_size(points) == (size_t)STRESS_COUNT;
+    for (int i = 0; i < STRESS_COUNT; i++) {
+        GridPoint point = {i % 317, i / 317};
+        double *distance = hashmap_get(points, &point);
+        GridPoint *stored = hashmap_get_key(points, &point);
+        if (distance == NULL || *distance != i * 0.5 || stored->x != point.x || stored->y != point.y) {
+            points_match = false;
+        }
+    }
+    check(points_match, "struct keys compared byte by byte");
+    hashmap_destroy(points);
+}
+
+void test_hashmap_stress_cached_hashes() {
+    printf("Testing HashMap growth reuses cached hashes...\n");
+    HashMap *map = hashmap_create(&TYPE_COUNTING_INT, NULL);
+
+    hash_calls = 0;
+    compare_calls = 0;
+    for (int i = 0; i < STRESS_COUNT; i++) {
+        hashmap_add(map, &i);
+    }
+    check(hash_calls == (size_t)STRESS_COUNT, "one hash per insertion, none during growth");
+    check(compare_calls == 0, "no comparator calls when inserting distinct keys");
+
+    compare_calls = 0;
+    for (int i = 0; i < STRESS_COUNT; i++) {
+        hashmap_contains(map, &i);
+    }
+    check(compare_calls == (size_t)STRESS_COUNT, "one comparator call per successful lookup");
+
+    hashmap_destroy(map);
+}
+
+void test_hashmap_stress_incremental_resize() {
+    printf("Testing HashMap incremental resizing...\n");
+    HashMap *map = hashmap_create(&TYPE_INT, &TYPE_INT);
+    hashmap_set_migration_budget(map, 1);
+
+    bool saw_migration = false;
+    bool finished_before_grow = true;
+    bool lookups_match = true;
+    bool iteration_matches = true;
+    for (int i = 0; i < STRESS_COUNT; i++) {
+        size_t capacity = hashmap_capacity(map);
+        bool migrating = hashmap_migrating(map);
+        hashmap_set(map, &i, &i);
+        if (hashmap_capacity(map) != capacity && migrating) {
+            finished_before_grow = false;
+        }
+        if (hashmap_migrating(map)) {
+            saw_migration = true;
+            int probe_key = i / 2;
+            int *value = hashmap_get(map, &probe_key);
+            if (value == NULL || *value != probe_key) {
+                lookups_match = false;
+            }
+            if (i % 1024 == 0) {
+                size_t counted = 0;
+                HASHMAP_KEYS_FOREACH(map, int *key, { (void)key; counted++; });
+                if (counted != hashmap_size(map)) {
+                    iteration_matches = false;
+                }
+            }
+        }
+    }
+    check(saw_migration, "growth spreads over several insertions");
+    check(finished_before_grow, "each migration finishes before the next grow, even at a budget of 1");
+    check(lookups_match, "lookups see entries in both tables while migrating");
+    check(iteration_matches, "iteration covers both tables while migrating");
+
+    for (int i = 0; i < STRESS_COUNT; i += 2) {
+        hashmap_remove(map, &i);
+    }
+    check(hashmap_size(map) == (size_t)(STRESS_COUNT / 2), "size after removing half the keys");
+
+    bool survivors_match = true;
+    for (int i = 0; i < STRESS_COUNT; i++) {
+        if (hashmap_contains(map, &i) != (i % 2 == 1)) {
+            survivors_match = false;
+        }
+    }
+    check(survivors_match, "only odd keys remain");
+
+    hashmap_destroy(map);
+}
+
+void test_hashmap_stress_capacity() {
+    printf("Testing HashMap capacity planning...\n");
+    HashMap *map = hashmap_create_with_capacity(&TYPE_INT, &TYPE_INT, STRESS_COUNT);
+    size_t initial_capacity = hashmap_capacity(map);
+    for (int i = 0; i < STRESS_COUNT; i++) {
+        hashmap_set(map, &i, &i);
+    }
+    check(hashmap_capacity(map) == initial_capacity, "a map created with capacity never grows while filled");
+
+    for (int i = 0; i < STRESS_COUNT - 100; i++) {
+        hashmap_remove(map, &i);
+    }
+    hashmap_shrink_to_fit(map);
+    check(hashmap_capacity(map) <= 256, "shrink to fit after mass removal");
+    bool survivors_match = true;
+    for (int i = 0; i < STRESS_COUNT; i++) {
+        int *value = hashmap_get(map, &i);
+        if ((value != NULL) != (i >= STRESS_COUNT - 100) || (value != NULL && *value != i)) {
+            survivors_match = false;
+        }
+    }
+    check(survivors_match, "entries survive shrinking");
+
+    hashmap_reserve(map, STRESS_COUNT);
+    size_t reserved_capacity = hashmap_capacity(map);
+    for (int i = 0; i < STRESS_COUNT; i++) {
+        hashmap_set(map, &i, &i);
+    }
+    check(hashmap_capacity(map) == reserved_capacity, "a reserved map never grows while filled");
+    hashmap_destroy(map);
+
+    HashMap *window = hashmap_create(&TYPE_INT, &TYPE_INT);
+    hashmap_set_shrink_threshold(window, 0.125);
+    for (int i = 0; i < STRESS_COUNT; i++) {
+        hashmap_set(window, &i, &i);
+    }
+    for (int i = 0; i < STRESS_COUNT - 10; i++) {
+        hashmap_remove(window, &i);
+    }
+    check(hashmap_capacity(window) == HASHMAP_INITIAL_CAPACITY, "removals shrink down to the initial capacity");
+    check(hashmap_size(window) == 10 && hashmap_contains(window, &(int){STRESS_COUNT - 1}), "entries survive shrinking on removal");
+    hashmap_destroy(window);
+
+    HashMap *dense = hashmap_create_dense(&TYPE_INT, &TYPE_INT);
+    hashmap_reserve(dense, STRESS_COUNT);
+    size_t dense_capacity = hashmap_capacity(dense);
+    size_t entry_capacity = dense->entry_capacity;
+    for (int i = 0; i < STRESS_COUNT; i++) {
+        hashmap_set(dense, &i, &i);
+    }
+    check(hashmap_capacity(dense) == dense_capacity && dense->entry_capacity == entry_capacity, "a reserved dense map never grows while filled");
+    for (int i = 0; i < STRESS_COUNT; i += 2) {
+        hashmap_remove(dense, &i);
+    }
+    hashmap_shrink_to_fit(dense);
+    check(dense->entry_count == hashmap_size(dense) && dense->entry_capacity < entry_capacity, "shrinking a dense map compacts its entries");
+    int expected = 1;
+    bool in_order = true;
+    HASHMAP_KEYS_FOREACH(dense, int *key, {
+        in_order = in_order && *key == expected;
+        expected += 2;
+    });
+    check(in_order && expected == STRESS_COUNT + 1, "shrinking a dense map keeps insertion order");
+    hashmap_destroy(dense);
+}
+
+void test_hashmap_stress_clone() {
+    printf("Testing HashMap cloning...\n");
+    HashMap *tombstoned = hashmap_create(&TYPE_INT, &TYPE_INT);
+    HashMap *dense = hashmap_create_dense(&TYPE_INT, &TYPE_INT);
+    for (int i = 0; i < STRESS_COUNT; i++) {
+        hashmap_set(tombstoned, &i, &i);
+        hashmap_set(dense, &i, &i);
+    }
+    for (int i = 0; i < STRESS_COUNT; i += 4) {
+        hashmap_remove(tombstoned, &i);
+        hashmap_remove(dense, &i);
+    }
+
+    HashMap *migrating = hashmap_create(&TYPE_INT, &TYPE_INT);
+    hashmap_set_migration_budget(migrating, 8);
+    bool saw_migration = false;
+    for (int i = 0; i < STRESS_COUNT && !saw_migration; i++) {
+        hashmap_set(migrating, &i, &i);
+        saw_migration = i > STRESS_COUNT / 4 && hashmap_migrating(migrating);
+    }
+    check(saw_migration, "clone source is migrating");
+
+    // Each clone must hold the same pairs in the same order, and survive changes to its source
+    HashMap *maps[] = {tombstoned, migrating, dense};
+    const char *names[] = {"pointer map with tombstones", "migrating map", "dense map"};
+    for (size_t m = 0; m < sizeof(maps) / sizeof(maps[0]); m++) {
+        HashMap *map = maps[m];
+        const char *name = names[m];
+        HashMap *clone = hashmap_clone(map, map->value_methods);
+
+        int *order = malloc(hashmap_size(map) * sizeof(int));
+        size_t position = 0;
+        HASHMAP_KEYS_FOREACH(map, int *key, { order[position++] = *key; });
+        bool same_order = hashmap_size(clone) == hashmap_size(map);
+        position = 0;
+        HASHMAP_KEYS_FOREACH(clone, int *key, {
+            same_order = same_order && position < hashmap_size(map) && *key == order[position];
+            position++;
+        });
+        free(order);
+        checkf(same_order && position == hashmap_size(map), "%s : clone iterates like the original", name);
+
+        bool lookups_match = true;
+        HASHMAP_PAIRS_FOREACH(map, int *key, int *value, {
+            int *cloned = hashmap_get(clone, key);
+            lookups_match = lookups_match && cloned != NULL && *cloned == *value && cloned != value;
+        });
+        checkf(lookups_match, "%s : clone finds every key with its own copy of the value", name);
+
+        size_t size = hashmap_size(clone);
+        for (int i = 0; i < STRESS_COUNT; i += 3) {
+            hashmap_remove(map, &i);
+            int value = -i;
+            hashmap_set(clone, &(int){i + STRESS_COUNT}, &value);
+        }
+        hashmap_destroy(map);
+        bool independent = true;
+        for (int i = 1; i < STRESS_COUNT; i += 3) {
+            int *value = hashmap_get(clone, &i);
+            independent = independent && (value == NULL || *value == i);
+        }
+        checkf(independent && hashmap_size(clone) >= size, "%s : clone is independent of the original", name);
+        hashmap_destroy(clone);
+    }
+
+    HashMap *map = hashmap_create_inline(&TYPE_INT, sizeof(int), sizeof(int));
+    for (int i = 0; i < STRESS_COUNT; i++) {
+        hashmap_set(map, &i, &i);
+    }
+    HashMap *clone = hashmap_clone(map, NULL);
+    (*(int *)hashmap_get(clone, &(int){7}))++;
+    check(*(int *)hashmap_get(map, &(int){7}) == 7 && *(int *)hashmap_get(clone, &(int){7}) == 8, "inline clone has its own values");
+    check(hashmap_size(clone) == (size_t)STRESS_COUNT && hashmap_contains(clone, &(int){STRESS_COUNT - 1}), "inline clone finds every key");
+    hashmap_destroy(map);
+    hashmap_destroy(clone);
+}
+
+void test_hashmap_stress_seeding() {
+    printf("Testing HashMap seeding and the probe length watchdog...\n");
+    HashMap *first = hashmap_create(&TYPE_INT, &TYPE_INT);
+    HashMap *second = hashmap_create(&TYPE_INT, &TYPE_INT);
+    check(first->seed != second->seed, "maps are seeded independently");
+    check(hashmap_hash(first, &(int){1}) != hashmap_hash(second, &(int){1}), "the seed is part of the hash");
+    hashmap_reseed(second, first->seed);
+    check(hashmap_hash(first, &(int){1}) == hashmap_hash(second, &(int){1}), "maps with the same seed hash alike");
+    check(hashmap_hash(first, &(int){1}) == int_seeded_hash_function(&(int){1}, first->seed), "built-in key types are hashed with their seeded hash");
+    hashmap_destroy(first);
+    hashmap_destroy(second);
+
+    for (int watchdog = 0; watchdog <= 1; watchdog++) {
+        HashMap *map = hashmap_create(&TYPE_FLOODED_INT, &TYPE_INT);
+        hashmap_set_watchdog(map, watchdog);
+        hashmap_reseed(map, 42);
+        for (int i = 0; i < 2000; i++) {
+            hashmap_set(map, &i, &i);
+        }
+        bool lookups_match = hashmap_size(map) == 2000;
+        for (int i = 0; i < 2000; i++) {
+            int *value = hashmap_get(map, &i);
+            lookups_match = lookups_match && value != NULL && *value == i;
+        }
+        check(lookups_match, "lookups in a flooded map");
+        check((map->seed != 42) == watchdog, watchdog ? "the watchdog reseeds a flooded map" : "a map without watchdog keeps its seed");
+        hashmap_destroy(map);
+    }
+}
+
 int main(){
-    return 0;
-}
\ No newline at end of file
+    for (hashmap_probe probe = HASHMAP_PROBE_TRIANGULAR; probe <= HASHMAP_PROBE_ROBIN_HOOD; probe++) {
+        test_hashmap_stress_insert_lookup(probe);
+        test_hashmap_stress_churn(probe);
+        test_hashmap_stress_sliding_window(probe);
+    }
+    test_hashmap_stress_cached_hashes();
+    test_hashmap_stress_incremental_resize();
+    test_hashmap_stress_hashed_and_batched();
+    test_hashmap_stress_dense();
+    test_hashmap_stress_inline(0);
+    test_hashmap_stress_inline(8);
+    test_hashmap_stress_capacity();
+    test_hashmap_stress_clone();
+    test_hashmap_stress_seeding();
+    return check_summary("HashMap stress");
+}
@@ -127,11 +127,108 @@ void test_hashmap_printf() {
     hashmap_destroy(map);
 }
 
+void test_hashmap_entry() {
+    printf("Testing HashMap entries...\n");
+    HashMap *map = hashmap_create(&TYPE_STRING, &TYPE_INT);
+
+    char *words[] = {"apple", "pear", "apple", "plum", "apple", "pear"};
+    size_t distinct = 0;
+    for (size_t i = 0; i < sizeof(words) / sizeof(words[0]); i++) {
+        bool inserted;
+        void *entry = hashmap_entry(map, words[i], &inserted);
+        if (inserted) {
+            distinct++;
+        }
+        (*(int *)hashmap_entry_value(map, entry))++;
+    }
+
+    int *apples = hashmap_get(map, "apple");
+    if (distinct == 3 && hashmap_size(map) == 3 && apples && *apples == 3) {
+        printf("Entries counted %zu distinct words, apple: %d\n", distinct, *apples);
+    } else {
+        printf("Entries counted words incorrectly.\n");
+    }
+
+    void *entry = hashmap_entry(map, "plum", NULL);
+    hashmap_entry_set(map, entry, &(int){7});
+    if (strcmp(hashmap_entry_key(map, entry), "plum") == 0 && *(int *)hashmap_get(map, "plum") == 7) {
+        printf("Entry value was replaced successfully.\n");
+    } else {
+        printf("Entry value was not replaced.\n");
+    }
+
+    hashmap_destroy(map);
+}
+
+void test_hashmap_inline() {
+    printf("Testing inline HashMap...\n");
+    HashMap *map = hashmap_create_inline(&TYPE_INT, sizeof(int), sizeof(int));
+
+    int key1 = 1;
+    int key2 = 2;
+    int value1 = 10;
+    int value2 = 20;
+
+    hashmap_set(map, &key1, &value1);
+    hashmap_set(map, &key2, &value2);
+    (*(int *)hashmap_get(map, &key1))++;
+
+    int *retrieved_value1 = hashmap_get(map, &key1);
+    if (retrieved_value1 && *retrieved_value1 == value1 + 1) {
+        printf("Value for key1 was updated in place: %d\n", *retrieved_value1);
+    } else {
+        printf("Value for key1 was not updated in place.\n");
+    }
+
+    hashmap_remove(map, &key2);
+    if (hashmap_contains(map, &key2)) {
+        printf("Key2 was not removed successfully.\n");
+    } else {
+        printf("Key2 was removed successfully.\n");
+    }
+
+    hashmap_destroy(map);
+}
+
+void test_hashmap_owned() {
+    printf("Testing HashMap ownership transfer...\n");
+    HashMap *map = hashmap_create(&TYPE_STRING, &TYPE_INT);
+
+    char *key = string_copy_constructor("owned");
+    int *value = int_copy_constructor(&(int){30});
+    hashmap_set_owned(map, key, value);
+    hashmap_set_owned(map, string_copy_constructor("owned"), int_copy_constructor(&(int){31}));
+
+    if (hashmap_get_key(map, "owned") == key && *(int *)hashmap_get(map, "owned") == 31) {
+        printf("Owned entry kept its key and took the new value.\n");
+    } else {
+        printf("Owned entry was not stored as given.\n");
+    }
+
+    void *taken_key, *taken_value;
+    if (hashmap_take(map, "owned", &taken_key, &taken_value) && taken_key == key && !hashmap_contains(map, "owned")) {
+        printf("Entry was taken successfully: %s = %d\n", (char *)taken_key, *(int *)taken_value);
+        string_destructor(taken_key);
+        int_destructor(taken_value);
+    } else {
+        printf("Entry was not taken.\n");
+    }
+
+    if (hashmap_take(map, "owned", NULL, NULL)) {
+        printf("Taking an absent key succeeded.\n");
+    }
+
+    hashmap_destroy(map);
+}
+
 int main() {
     test_hashmap_creation();
     test_hashmap_insertion_and_retrieval();
     test_hashmap_iteration();
     test_hashmap_deletion();
     test_hashmap_printf();
+    test_hashmap_entry();
+    test_hashmap_inline();
+    test_hashmap_owned();
     return 0;
 }
\ No newline at end of file
@@ -0,0 +1,92 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "hashset.h"
+#include "typemethods.h"
+#include "testtools.h"
+
+static type_methods TYPE_INT = TYPE_METHODS(int);
+static type_methods TYPE_STRING = TYPE_METHODS(string);
+
+// Set holding the ints from first to last, stepping by step
+static HashSet *int_range(int first, int last, int step) {
+    HashSet *set = hashset_create(&TYPE_INT);
+    for (int i = first; i <= last; i += step) {
+        hashset_add(set, &i);
+    }
+    return set;
+}
+
+void test_hashset_basic() {
+    printf("Testing HashSet insertion, lookup and removal...\n");
+    HashSet *set = hashset_create(&TYPE_STRING);
+    check(set->map->slot_size == sizeof(size_t) + sizeof(void *), "slots hold only the hash and the key");
+
+    char buffer[16];
+    for (int i = 0; i < 1000; i++) {
+        snprintf(buffer, sizeof(buffer), "key%d", i);
+        hashset_add(set, buffer);
+        hashset_add(set, buffer);
+    }
+    check(hashset_size(set) == 1000, "adding twice keeps one element");
+    check(hashset_contains(set, "key999") && !hashset_contains(set, "key1000"), "lookups");
+    check(strcmp(hashset_get_key(set, "key42"), "key42") == 0, "stored element is returned");
+
+    for (int i = 0; i < 1000; i += 2) {
+        snprintf(buffer, sizeof(buffer), "key%d", i);
+        hashset_remove(set, buffer);
+    }
+    size_t counted = 0;
+    bool only_odd = true;
+    HASHSET_FOREACH(set, char *data, {
+        counted++;
+        only_odd = only_odd && (data[strlen(data) - 1] - '0') % 2 == 1;
+    });
+    check(counted == 500 && hashset_size(set) == 500, "iteration after removal");
+    check(only_odd, "iteration sees only remaining elements");
+
+    HashSet *clone = hashset_clone(set);
+    hashset_clear(set);
+    check(hashset_empty(set), "clear empties the set");
+    check(hashset_size(clone) == 500 && hashset_contains(clone, "key1"), "clone outlives the original's elements");
+    hashset_destroy(clone);
+    hashset_destroy(set);
+}
+
+void test_hashset_algebra() {
+    printf("Testing HashSet union, intersection and difference...\n");
+    HashSet *evens = int_range(0, 10000, 2);
+    HashSet *triples = int_range(0, 300, 3);
+
+    HashSet *both = hashset_intersection(evens, triples);
+    HashSet *either = hashset_union(triples, evens);
+    HashSet *evens_only = hashset_difference(evens, triples);
+    HashSet *triples_only = hashset_difference(triples, evens);
+
+    bool matches = true;
+    for (int i = -1; i <= 10001; i++) {
+        bool even = i >= 0 && i % 2 == 0;
+        bool triple = i >= 0 && i <= 300 && i % 3 == 0;
+        matches = matches && hashset_contains(both, &i) == (even && triple);
+        matches = matches && hashset_contains(either, &i) == (even || triple);
+        matches = matches && hashset_contains(evens_only, &i) == (even && !triple);
+        matches = matches && hashset_contains(triples_only, &i) == (triple && !even);
+    }
+    check(matches, "set algebra membership");
+    check(hashset_size(both) == 51 && hashset_size(either) == 5001 + 101 - 51, "set algebra sizes");
+    check(hashset_size(evens_only) == 5001 - 51 && hashset_size(triples_only) == 101 - 51, "difference sizes");
+
+    hashset_destroy(both);
+    hashset_destroy(either);
+    hashset_destroy(evens_only);
+    hashset_destroy(triples_only);
+    hashset_destroy(evens);
+    hashset_destroy(triples);
+}
+
+int main() {
+    test_hashset_basic();
+    test_hashset_algebra();
+    return check_summary("HashSet");
+}
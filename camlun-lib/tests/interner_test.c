@@ -0,0 +1,89 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "hashmap.h"
+#include "interner.h"
+#include "typemethods.h"
+#include "testtools.h"
+
+static type_methods TYPE_INT = TYPE_METHODS(int);
+static type_methods TYPE_INTERNED = TYPE_METHODS(interned);
+static type_methods TYPE_INTERNED_SEEDED = TYPE_METHODS_SEEDED(interned);
+
+void test_interner_canonical() {
+    printf("Testing Interner canonical strings and symbols...\n");
+    Interner *interner = interner_create();
+    char buffer[16];
+
+    strcpy(buffer, "12,34");
+    char *first = interner_intern(interner, buffer);
+    strcpy(buffer, "56,78");
+    char *second = interner_intern(interner, buffer);
+    strcpy(buffer, "12,34");
+    char *again = interner_intern(interner, buffer);
+
+    check(first == again, "equal strings share one canonical pointer");
+    check(first != second, "different strings get different pointers");
+    check(first != buffer && strcmp(first, "12,34") == 0, "canonical strings are copies");
+    check(interner_size(interner) == 2, "each distinct string is counted once");
+
+    check(interner_symbol(interner, "12,34") == 0, "symbols follow first interning order");
+    check(interner_symbol(interner, "56,78") == 1, "symbols are dense");
+    check(interner_symbol(interner, "90,12") == 2, "symbol interns new strings");
+    check(interner_string(interner, 1) == second, "symbols map back to the canonical string");
+    check(interner_string(interner, 3) == NULL, "unknown symbols have no string");
+
+    check(interner_find(interner, "12,34") == first, "find returns the canonical pointer");
+    check(interner_find(interner, "34,12") == NULL, "find does not intern");
+    check(interner_size(interner) == 3, "find leaves the size alone");
+
+    // Canonical pointers stay put while the table grows
+    for (int i = 0; i < 5000; i++) {
+        snprintf(buffer, sizeof(buffer), "%d,%d", i, i);
+        interner_intern(interner, buffer);
+    }
+    check(interner_find(interner, "12,34") == first && strcmp(first, "12,34") == 0, "canonical strings survive growth");
+    check(interner_string(interner, interner_symbol(interner, "4999,4999")) == interner_find(interner, "4999,4999"),
+          "symbols and strings agree after growth");
+    interner_destroy(interner);
+}
+
+void test_interner_type_methods() {
+    printf("Testing identity keyed HashMaps...\n");
+    type_methods *key_types[] = {&TYPE_INTERNED, &TYPE_INTERNED_SEEDED};
+    const char *names[] = {"unseeded", "seeded"};
+    for (size_t m = 0; m < 2; m++) {
+        type_methods *key_methods = key_types[m];
+        const char *name = names[m];
+        Interner *interner = interner_create();
+        HashMap *map = hashmap_create(key_methods, &TYPE_INT);
+        char buffer[16];
+        for (int i = 0; i < 3000; i++) {
+            snprintf(buffer, sizeof(buffer), "%d,%d", i / 64, i % 64);
+            hashmap_set(map, interner_intern(interner, buffer), &i);
+        }
+        checkf(hashmap_size(map) == 3000, "%s map holds every interned key", name);
+
+        bool found = true;
+        for (int i = 0; i < 3000; i++) {
+            snprintf(buffer, sizeof(buffer), "%d,%d", i / 64, i % 64);
+            int *value = hashmap_get(map, interner_find(interner, buffer));
+            found = found && value != NULL && *value == i;
+        }
+        checkf(found, "%s map finds keys by canonical pointer", name);
+
+        strcpy(buffer, "0,0");
+        checkf(!hashmap_contains(map, buffer), "%s map does not match equal characters at another address", name);
+
+        hashmap_destroy(map);
+        check(interner_size(interner) == 3000, "destroying the map leaves the interned strings");
+        interner_destroy(interner);
+    }
+}
+
+int main() {
+    test_interner_canonical();
+    test_interner_type_methods();
+    return check_summary("Interner");
+}
@@ -0,0 +1,135 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "lrucache.h"
+#include "typemethods.h"
+#include "testtools.h"
+
+static type_methods TYPE_INT = TYPE_METHODS(int);
+static type_methods TYPE_STRING = TYPE_METHODS(string);
+
+typedef struct {
+    int count;
+    int last_key;
+    int value_sum;
+} evict_log;
+
+static void record_eviction(void *key, void *value, void *context) {
+    evict_log *log = context;
+    log->count++;
+    log->last_key = *(int *)key;
+    log->value_sum += *(int *)value;
+}
+
+static int *get_int(LruCache *cache, int key) {
+    return lrucache_get(cache, &key);
+}
+
+static void put_int(LruCache *cache, int key, int value) {
+    lrucache_put(cache, &key, &value);
+}
+
+void test_lrucache_lru() {
+    printf("Testing LRU eviction order...\n");
+    LruCache *cache = lrucache_create(&TYPE_INT, &TYPE_INT, 3);
+    evict_log log = {0};
+    lrucache_set_evict_callback(cache, record_eviction, &log);
+
+    put_int(cache, 1, 10);
+    put_int(cache, 2, 20);
+    put_int(cache, 3, 30);
+    check(lrucache_size(cache) == 3, "cache fills to capacity");
+    check(*get_int(cache, 1) == 10, "hit returns the value");
+
+    put_int(cache, 4, 40);
+    check(log.count == 1 && log.last_key == 2 && log.value_sum == 20, "the least recently used entry is evicted");
+    check(lrucache_size(cache) == 3, "size stays at capacity");
+    check(get_int(cache, 2) == NULL, "evicted keys miss");
+
+    put_int(cache, 3, 33);
+    put_int(cache, 5, 50);
+    check(log.last_key == 1, "a put refreshes the entry it replaces");
+    check(*(int *)lrucache_peek(cache, &(int){3}) == 33, "put replaces the value");
+
+    check(lrucache_hits(cache) == 1 && lrucache_misses(cache) == 1, "hits and misses are counted");
+    check(lrucache_evictions(cache) == 2, "evictions are counted");
+
+    lrucache_peek(cache, &(int){4});
+    put_int(cache, 6, 60);
+    check(log.last_key == 4, "peek leaves the recency alone");
+
+    lrucache_remove(cache, &(int){5});
+    check(!lrucache_contains(cache, &(int){5}) && lrucache_size(cache) == 2, "remove drops the entry");
+    check(log.count == 3, "remove does not report an eviction");
+    put_int(cache, 7, 70);
+    check(log.count == 3 && lrucache_size(cache) == 3, "removed nodes are reused before evicting");
+
+    lrucache_clear(cache);
+    check(lrucache_size(cache) == 0 && !lrucache_contains(cache, &(int){7}), "clear empties the cache");
+    for (int i = 0; i < 10; i++) {
+        put_int(cache, i, i);
+    }
+    check(lrucache_size(cache) == 3 && lrucache_contains(cache, &(int){9}) && !lrucache_contains(cache, &(int){6}),
+          "the cache refills after clear");
+    lrucache_destroy(cache);
+}
+
+void test_lrucache_clock() {
+    printf("Testing CLOCK second chance eviction...\n");
+    LruCache *cache = lrucache_create_clock(&TYPE_INT, &TYPE_INT, 3);
+    evict_log log = {0};
+    lrucache_set_evict_callback(cache, record_eviction, &log);
+
+    put_int(cache, 1, 10);
+    put_int(cache, 2, 20);
+    put_int(cache, 3, 30);
+    get_int(cache, 1);
+    put_int(cache, 4, 40);
+    check(log.count == 1 && log.last_key == 2, "the clock skips referenced entries once");
+    check(lrucache_contains(cache, &(int){1}), "a referenced entry gets a second chance");
+
+    get_int(cache, 1);
+    get_int(cache, 3);
+    get_int(cache, 4);
+    put_int(cache, 5, 50);
+    check(log.count == 2 && lrucache_size(cache) == 3, "the clock evicts when every entry was referenced");
+    lrucache_destroy(cache);
+}
+
+void test_lrucache_workload() {
+    printf("Testing caches under a hot and cold workload...\n");
+    LruCache *caches[] = {lrucache_create(&TYPE_STRING, &TYPE_INT, 96), lrucache_create_clock(&TYPE_STRING, &TYPE_INT, 96)};
+    const char *names[] = {"LRU", "CLOCK"};
+    for (size_t m = 0; m < 2; m++) {
+        LruCache *cache = caches[m];
+        const char *name = names[m];
+        char key[32];
+        // Hot set of 64 keys looked up between streams of one off keys
+        for (int round = 0; round < 2000; round++) {
+            for (int hot = 0; hot < 4; hot++) {
+                snprintf(key, sizeof(key), "hot-%d", (round * 4 + hot) % 64);
+                if (lrucache_get(cache, key) == NULL) {
+                    lrucache_put(cache, key, &round);
+                }
+            }
+            snprintf(key, sizeof(key), "cold-%d", round);
+            if (lrucache_get(cache, key) == NULL) {
+                lrucache_put(cache, key, &round);
+            }
+        }
+        checkf(lrucache_hits(cache) > 7000, "%s keeps the hot set", name);
+        checkf(lrucache_size(cache) == lrucache_capacity(cache), "%s never exceeds capacity", name);
+        checkf(lrucache_hits(cache) + lrucache_misses(cache) == 10000, "%s counts every lookup", name);
+        lrucache_reset_stats(cache);
+        check(lrucache_hits(cache) == 0 && lrucache_misses(cache) == 0 && lrucache_evictions(cache) == 0, "stats reset");
+        lrucache_destroy(cache);
+    }
+}
+
+int main() {
+    test_lrucache_lru();
+    test_lrucache_clock();
+    test_lrucache_workload();
+    return check_summary("LruCache");
+}
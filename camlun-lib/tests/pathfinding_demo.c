@@ -5,6 +5,7 @@
 #include <assert.h>
 
 #include "graph.h"
+#include "interner.h"
 #include "treeset.h"
 #include "tuple.h"
 #include "typemethods.h"
@@ -30,15 +31,33 @@ DEFINE_COMPARATOR(node_value, NodeValue, {
 DEFINE_HASH_FUNCTION(node_value, NodeValue, {})
 
 TYPE_INIT(static type_methods TYPE_NODE_VALUE, node_value);
-TYPE_INIT(static type_methods TYPE_STRING, string);
+TYPE_INIT(static type_methods TYPE_INTERNED, interned);
 TYPE_INIT(static type_methods TYPE_DOUBLE, double);
 
 TUPLE_INIT(static type_methods TYPE_PQNODE, double priority; char *id;, pqnode, {
     return VALUE_COMPARE(double, _first->priority, _second->priority);
 })
 
-static Graph *load_graph_from_file(FILE *file) {
-    Graph *graph = graph_create(&TYPE_STRING, &TYPE_NODE_VALUE);
+// Counts the add and link commands so the graph can be sized before loading, then rewinds the file
+static void count_graph_commands(FILE *file, size_t *vertex_count, size_t *edge_count) {
+    *vertex_count = 0;
+    *edge_count = 0;
+    char line[1024];
+    while (fgets(line, sizeof(line), file) != NULL) {
+        if (strncmp(line, "add ", 4) == 0) {
+            (*vertex_count)++;
+        } else if (strncmp(line, "link ", 5) == 0) {
+            (*edge_count)++;
+        }
+    }
+    rewind(file);
+}
+
+// Vertex ids are interned, so the graph and the search key everything by pointer
+static Graph *load_graph_from_file(FILE *file, Interner *ids) {
+    size_t vertex_count, edge_count;
+    count_graph_commands(file, &vertex_count, &edge_count);
+    Graph *graph = graph_create_with_capacity(&TYPE_INTERNED, &TYPE_NODE_VALUE, vertex_count, edge_count);
 
     while (1) {
         char cmd_str[16];
@@ -54,18 +73,20 @@ static Graph *load_graph_from_file(FILE *file) {
             #if DEBUG
             // printf("Adding vertex %s\n", id);
             #endif
-            graph_set(graph, id, &(NodeValue){.x = x, .y = y});
+            graph_set(graph, interner_intern(ids, id), &(NodeValue){.x = x, .y = y});
         } else if (strcmp(cmd_str, "link") == 0) {
             char from_id[256];
             char to_id[256];
             if (fscanf(file, "%s %s", from_id, to_id) != 2) {
                 break;
             }
-            if (!graph_contains(graph, from_id) || !graph_contains(graph, to_id)) {
+            char *from = interner_find(ids, from_id);
+            char *to = interner_find(ids, to_id);
+            if (!from || !to || !graph_contains(graph, from) || !graph_contains(graph, to)) {
                 fprintf(stderr, "Error: Vertex not found %s %s\n", from_id, to_id);
                 continue;
             }
-            graph_connect(graph, from_id, to_id);
+            graph_connect(graph, from, to);
         } else {
             break;
         }
@@ -73,13 +94,13 @@ static Graph *load_graph_from_file(FILE *file) {
     return graph;
 }
 
-static Graph *load_graph_from_filename(char *filename) {
+static Graph *load_graph_from_filename(char *filename, Interner *ids) {
     FILE *file = fopen(filename, "r");
     if (file == NULL) {
         fprintf(stderr, "Error: Unable to open file %s\n", filename);
         return NULL;
     }
-    Graph *graph = load_graph_from_file(file);
+    Graph *graph = load_graph_from_file(file, ids);
     fclose(file);
     return graph;
 }
@@ -123,30 +144,33 @@ static Vector *find_path_by_astar(Graph *graph, char *from, char *to, heuristic_
         return NULL;
     }
 
-    Vector *frontier = vector_create(&TYPE_PQNODE);
-    HashMap *came_from = hashmap_create(&TYPE_STRING, &TYPE_STRING);
-    HashMap *cost_so_far = hashmap_create(&TYPE_STRING, &TYPE_DOUBLE);
+    Vector *frontier = vector_create_sized(sizeof(pqnode), &TYPE_PQNODE);
+    HashMap *came_from = hashmap_create(&TYPE_INTERNED, &TYPE_INTERNED);
+    HashMap *cost_so_far = hashmap_create(&TYPE_INTERNED, &TYPE_DOUBLE);
 
     heap_offer(frontier, &(pqnode){.priority = 0, .id = from}, false);
     hashmap_set(came_from, from, "");
     hashmap_set(cost_so_far, from, &(double){0});
 
     while (vector_size(frontier) > 0) {
-        pqnode *current_pqnode = heap_poll(frontier, false);
-        char *current_id = current_pqnode->id;
-        pqnode_destructor(current_pqnode);
+        pqnode current_pqnode;
+        heap_poll_into(frontier, &current_pqnode, false);
+        char *current_id = current_pqnode.id;
 
-        if (strcmp(current_id, to) == 0) {
+        if (current_id == to) {
             break;
         }
 
         char *neighbour;
+        double current_cost = *(double *)hashmap_get(cost_so_far, current_id);
         GRAPH_OUT_ID_FOREACH(graph, current_id, neighbour, {
             assert(graph_contains(graph, neighbour));
             // printf("Checking %s -> %s\n", current_id, neighbour);
-            double new_cost = *(double *)hashmap_get(cost_so_far, current_id) + *(double *)graph_get_edge_value(graph, current_id, neighbour);
-            if( !hashmap_contains(cost_so_far, neighbour) || new_cost < *(double *)hashmap_get(cost_so_far, neighbour)) {
-                hashmap_set(cost_so_far, neighbour, &(double){new_cost});
+            double new_cost = current_cost + *(double *)graph_get_edge_value(graph, current_id, neighbour);
+            bool discovered;
+            double *neighbour_cost = hashmap_entry_value(cost_so_far, hashmap_entry(cost_so_far, neighbour, &discovered));
+            if( discovered || new_cost < *neighbour_cost) {
+                *neighbour_cost = new_cost;
                 double priority = new_cost + heur_fn(graph_get_vertex_value(graph, neighbour), graph_get_vertex_value(graph, to));
                 heap_offer(frontier, &(pqnode){.priority = priority, .id = neighbour}, false);
                 hashmap_set(came_from, neighbour, current_id);
@@ -155,11 +179,11 @@ static Vector *find_path_by_astar(Graph *graph, char *from, char *to, heuristic_
     }
 
     // Reconstruct Path
-    Vector *path = vector_create(&TYPE_STRING);
+    Vector *path = vector_create(&TYPE_INTERNED);
     char *current = to;
     while (current != NULL) {
         vector_push_back(path, current);
-        if (strcmp(current, from) == 0) break;
+        if (current == from) break;
         current = hashmap_get(came_from, current);
     }
 
@@ -215,19 +239,26 @@ int main(int argc, char **argv) {
         return 1;
     }
 
-    Graph *graph = load_graph_from_filename(graph_filename);
+    Interner *ids = interner_create();
+    Graph *graph = load_graph_from_filename(graph_filename, ids);
 
     if (!graph) {
         fprintf(stderr, "Failed to load graph from file: %s\n", graph_filename);
+        interner_destroy(ids);
         return 1;
     }
     calculate_edge_values(graph);
 
     clock_t start_time = clock();
-    Vector *path = find_path_by_astar(graph, from_id, to_id, heur_fn);
+    // Ids that were never interned are not in the graph either, searching with the
+    // argument itself lets find_path_by_astar report them
+    char *from = interner_find(ids, from_id);
+    char *to = interner_find(ids, to_id);
+    Vector *path = find_path_by_astar(graph, from ? from : from_id, to ? to : to_id, heur_fn);
     if(path == NULL){
         printf("Path not found\n");
         graph_destroy(graph);
+        interner_destroy(ids);
         return 1;
     }
     //return;
@@ -237,6 +268,7 @@ int main(int argc, char **argv) {
         printf("No path found from %s to %s.\n", from_id, to_id);
         if (path) vector_destroy(path);
         graph_destroy(graph);
+        interner_destroy(ids);
         return 1;
     }
 
@@ -255,5 +287,6 @@ int main(int argc, char **argv) {
 
     vector_destroy(path);
     graph_destroy(graph);
+    interner_destroy(ids);
     return 0;
 }
\ No newline at end of file
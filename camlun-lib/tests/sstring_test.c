@@ -0,0 +1,120 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "hashmap.h"
+#include "sstring.h"
+#include "typemethods.h"
+#include "testtools.h"
+
+static type_methods TYPE_INT = TYPE_METHODS(int);
+static type_methods TYPE_SSTRING = TYPE_METHODS(sstring);
+static type_methods TYPE_SSTRING_SEEDED = TYPE_METHODS_SEEDED(sstring);
+
+static const char *LONG_TEXT = "a string well past the inline capacity of an SString";
+
+void test_sstring_storage() {
+    printf("Testing SString inline and heap storage...\n");
+    SString *short_string = sstring_create("12,34");
+    check(sstring_length(short_string) == 5, "length is cached");
+    check(strcmp(sstring_data(short_string), "12,34") == 0, "short strings read back");
+    check(sstring_data(short_string) == short_string->inline_data, "short strings are stored in place");
+
+    char exact[SSTRING_INLINE_CAPACITY + 1];
+    memset(exact, 'x', SSTRING_INLINE_CAPACITY);
+    exact[SSTRING_INLINE_CAPACITY] = '\0';
+    SString *exact_string = sstring_create(exact);
+    check(sstring_data(exact_string) == exact_string->inline_data, "strings at the inline capacity stay in place");
+
+    SString *long_string = sstring_create(LONG_TEXT);
+    check(sstring_length(long_string) == strlen(LONG_TEXT), "long length is cached");
+    check(strcmp(sstring_data(long_string), LONG_TEXT) == 0, "long strings read back");
+    check(sstring_data(long_string) != LONG_TEXT, "created strings own their characters");
+
+    SString *copy = sstring_copy_constructor(long_string);
+    check(sstring_equals(copy, long_string), "copies are equal");
+    check(sstring_data(copy) != sstring_data(long_string), "copies own their characters");
+    check(copy->hash == long_string->hash, "copies carry the hash");
+
+    SString borrowed = sstring_borrow(LONG_TEXT);
+    check(sstring_data(&borrowed) == LONG_TEXT, "borrowed long strings point at the source");
+    check(sstring_equals(&borrowed, long_string), "borrowed and owned strings are equal");
+
+    SString *empty = sstring_default_constructor();
+    check(sstring_length(empty) == 0 && sstring_data(empty)[0] == '\0', "default strings are empty");
+
+    SString *prefix = sstring_create_length("12,34,56", 5);
+    check(sstring_length(prefix) == 5 && strcmp(sstring_data(prefix), "12,34") == 0,
+          "create_length stops at the length");
+
+    sstring_destructor(short_string);
+    sstring_destructor(exact_string);
+    sstring_destructor(long_string);
+    sstring_destructor(copy);
+    sstring_destructor(empty);
+    sstring_destructor(prefix);
+    sstring_destructor(NULL);
+}
+
+void test_sstring_comparators() {
+    printf("Testing SString comparators...\n");
+    SString a = sstring_borrow("abc");
+    SString b = sstring_borrow("abd");
+    SString longer = sstring_borrow("ab");
+    SString same = sstring_borrow("abc");
+
+    check(sstring_comparator(&a, &same) == 0, "equal strings compare equal");
+    check(sstring_comparator(&a, &b) != 0, "strings differing in a character are unequal");
+    check(sstring_comparator(&a, &b) == -sstring_comparator(&b, &a), "the order is antisymmetric");
+    check(sstring_comparator(&longer, &a) < 0, "shorter strings order first");
+
+    check(sstring_lexical_comparator(&a, &b) < 0, "lexical order compares characters");
+    check(sstring_lexical_comparator(&longer, &a) < 0, "lexical order puts prefixes first");
+    check(sstring_lexical_comparator(&a, &same) == 0, "lexical order finds equal strings");
+}
+
+void test_sstring_hashmap() {
+    printf("Testing SString keys in a HashMap...\n");
+    type_methods *key_types[] = {&TYPE_SSTRING, &TYPE_SSTRING_SEEDED};
+    const char *names[] = {"unseeded", "seeded"};
+    for (size_t m = 0; m < 2; m++) {
+        type_methods *key_methods = key_types[m];
+        const char *name = names[m];
+        HashMap *map = hashmap_create(key_methods, &TYPE_INT);
+        char buffer[64];
+        for (int i = 0; i < 2000; i++) {
+            // Mix of short ids like the generated maps use and ids past the inline capacity
+            snprintf(buffer, sizeof(buffer), i % 2 ? "%d,%d" : "vertex-%d-with-a-long-name-%d", i, i * 7);
+            SString key = sstring_borrow(buffer);
+            hashmap_set(map, &key, &i);
+        }
+        checkf(hashmap_size(map) == 2000, "%s map holds every key", name);
+
+        bool found = true;
+        for (int i = 0; i < 2000; i++) {
+            snprintf(buffer, sizeof(buffer), i % 2 ? "%d,%d" : "vertex-%d-with-a-long-name-%d", i, i * 7);
+            SString key = sstring_borrow(buffer);
+            int *value = hashmap_get(map, &key);
+            found = found && value != NULL && *value == i;
+        }
+        checkf(found, "%s map finds every key through a borrowed string", name);
+
+        SString missing = sstring_borrow("12,85");
+        checkf(!hashmap_contains(map, &missing), "%s map misses absent keys", name);
+
+        for (int i = 0; i < 2000; i += 2) {
+            snprintf(buffer, sizeof(buffer), "vertex-%d-with-a-long-name-%d", i, i * 7);
+            SString key = sstring_borrow(buffer);
+            hashmap_remove(map, &key);
+        }
+        checkf(hashmap_size(map) == 1000, "%s map removes long keys", name);
+        hashmap_destroy(map);
+    }
+}
+
+int main() {
+    test_sstring_storage();
+    test_sstring_comparators();
+    test_sstring_hashmap();
+    return check_summary("SString");
+}
@@ -0,0 +1,41 @@
+#ifndef TESTS_TESTTOOLS_H
+#define TESTS_TESTTOOLS_H
+
+#include <stdarg.h>
+#include <stdbool.h>
+#include <stdio.h>
+
+// Checks shared by the test programs. Each program counts the checks that failed
+// and returns check_summary from main, so that a failure shows in its exit status.
+
+static int failures = 0;
+
+static inline void check(bool condition, const char *message) {
+    if (!condition) {
+        printf("FAILED: %s\n", message);
+        failures++;
+    }
+}
+
+// check with a printf style message, for checks repeated over sizes or fixtures
+static inline void checkf(bool condition, const char *format, ...) {
+    if (!condition) {
+        va_list args;
+        va_start(args, format);
+        printf("FAILED: ");
+        vprintf(format, args);
+        printf("\n");
+        va_end(args);
+        failures++;
+    }
+}
+
+// Prints the closing line when every check passed, returns the number that failed
+static inline int check_summary(const char *suite) {
+    if (failures == 0) {
+        printf("All %s checks passed.\n", suite);
+    }
+    return failures;
+}
+
+#endif
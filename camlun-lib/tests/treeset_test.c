@@ -179,11 +179,45 @@ void test_treeset_printf() {
     treeset_destroy(set);
 }
 
+void test_treeset_owned() {
+    printf("Testing TreeSet ownership transfer...\n");
+    TreeSet *set = treeset_create(&int_methods);
+
+    int *values[10];
+    for (int i = 0; i < 10; i++) {
+        values[i] = int_copy_constructor(&(int){i * 10});
+        treeset_add_owned(set, values[i]);
+    }
+    treeset_add_owned(set, int_copy_constructor(&(int){40}));
+
+    if (treeset_size(set) == 10 && treeset_get_key(set, &(int){40}) == values[4]) {
+        printf("Owned elements were adopted without copies.\n");
+    } else {
+        printf("Owned elements were not adopted.\n");
+    }
+
+    // 30 has two children, its predecessor moves up in its place
+    int *taken = treeset_take(set, &(int){30});
+    if (taken == values[3] && treeset_size(set) == 9 && !treeset_contains(set, &(int){30}) && validate_treeset(set)) {
+        printf("Element was taken successfully.\n");
+    } else {
+        printf("Element was not taken.\n");
+    }
+    int_destructor(taken);
+
+    if (treeset_take(set, &(int){35}) != NULL || treeset_size(set) != 9) {
+        printf("Taking an absent element changed the set.\n");
+    }
+
+    treeset_destroy(set);
+}
+
 int main() {
     test_treeset_creation();
     test_treeset_insertion_and_validation();
     test_treeset_iteration();
     test_treeset_deletion_and_validation();
     test_treeset_printf();
+    test_treeset_owned();
     return 0;
 }
\ No newline at end of file
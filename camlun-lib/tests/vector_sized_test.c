@@ -0,0 +1,134 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "vector.h"
+#include "vector_ext.h"
+#include "typemethods.h"
+#include "testtools.h"
+
+static type_methods TYPE_DOUBLE = TYPE_METHODS(double);
+
+typedef struct {
+    int key;
+    char label[92];
+} record;
+
+static int record_comparator(void *first, void *second) {
+    return VALUE_COMPARE(int, ((record *)first)->key, ((record *)second)->key);
+}
+
+static type_methods TYPE_RECORD = {.cmp = record_comparator};
+
+static double get_double(Vector *vector, size_t pos) {
+    return *(double *)vector_get(vector, pos);
+}
+
+void test_vector_sized_modifiers() {
+    printf("Testing sized vector modifiers...\n");
+    Vector *vector = vector_create_sized(sizeof(double), &TYPE_DOUBLE);
+    check(VECTOR_SIZED(vector) && VECTOR_STRIDE(vector) == sizeof(double), "vector stores doubles in place");
+
+    for (int i = 0; i < 100; i++) {
+        vector_push_back(vector, &(double){i * 0.5});
+    }
+    check(vector_size(vector) == 100, "push_back grows the vector");
+    check(get_double(vector, 99) == 49.5, "elements survive reallocation");
+
+    vector_insert(vector, 0, &(double){-1});
+    vector_insert(vector, 50, &(double){-2});
+    check(get_double(vector, 0) == -1 && get_double(vector, 1) == 0, "insert at the front shifts elements");
+    check(get_double(vector, 50) == -2 && get_double(vector, 51) == 24.5, "insert in the middle shifts elements");
+
+    vector_erase(vector, 50);
+    vector_erase(vector, 0);
+    check(vector_size(vector) == 100 && get_double(vector, 50) == 25, "erase closes the gap");
+
+    vector_set(vector, 10, &(double){7.25});
+    vector_swap(vector, 10, 20);
+    check(get_double(vector, 20) == 7.25 && get_double(vector, 10) == 10, "set and swap move values");
+    check(*(double *)vector_first(vector) == 0 && *(double *)vector_last(vector) == 49.5, "first and last");
+
+    vector_pop_back(vector);
+    vector_resize(vector, 120);
+    check(get_double(vector, 98) == 49 && get_double(vector, 99) == 0 && get_double(vector, 119) == 0, "expand zero fills");
+    vector_truncate(vector, 10);
+    vector_compact(vector);
+    check(vector_size(vector) == 10 && vector_capacity(vector) >= 10, "truncate and compact");
+
+    double sum = 0;
+    double *value;
+    VECTOR_FOREACH(vector, value, { sum += *value; });
+    check(sum == 22.5, "foreach visits each element");
+
+    vector_clear(vector);
+    check(vector_empty(vector), "clear empties the vector");
+    vector_destroy(vector);
+}
+
+void test_vector_sized_copies() {
+    printf("Testing sized vector clones and slices...\n");
+    Vector *vector = vector_create_sized(sizeof(record), &TYPE_RECORD);
+    for (int i = 0; i < 40; i++) {
+        record entry = {.key = i};
+        snprintf(entry.label, sizeof(entry.label), "record %d", i);
+        vector_push_back(vector, &entry);
+    }
+
+    vector_swap(vector, 0, 39);
+    record *first = vector_get(vector, 0);
+    check(first->key == 39 && strcmp(first->label, "record 39") == 0, "swap moves records larger than the swap buffer");
+    vector_swap(vector, 0, 39);
+
+    Vector *clone = vector_clone(vector, &TYPE_RECORD);
+    check(VECTOR_STRIDE(clone) == sizeof(record) && vector_size(clone) == 40, "clone keeps the layout");
+    ((record *)vector_get(vector, 5))->key = -5;
+    check(((record *)vector_get(clone, 5))->key == 5, "clone owns its elements");
+
+    Vector slice = vector_slice(clone, 10, 5);
+    record *sliced = vector_get(&slice, 0);
+    check(vector_size(&slice) == 5 && sliced->key == 10 && strcmp(sliced->label, "record 10") == 0, "slice views the range");
+
+    for (int descending = 0; descending < 2; descending++) {
+        vector_sort(clone, descending);
+        bool ordered = true;
+        for (int i = 0; i < 40; i++) {
+            record *entry = vector_get(clone, i);
+            ordered &= entry->key == (descending ? 39 - i : i) && entry->label[0] == 'r';
+        }
+        check(ordered, descending ? "sort orders records beyond the stack scratch descending" : "sort orders records beyond the stack scratch");
+    }
+
+    vector_destroy(clone);
+    vector_destroy(vector);
+}
+
+void test_vector_sized_heap() {
+    printf("Testing sized vector heaps...\n");
+    Vector *heap = vector_create_sized(sizeof(record), &TYPE_RECORD);
+    for (int i = 0; i < 200; i++) {
+        heap_offer(heap, &(record){.key = (i * 37) % 200}, false);
+    }
+
+    record top;
+    bool ordered = true;
+    for (int i = 0; i < 100; i++) {
+        ordered &= heap_poll_into(heap, &top, false) && top.key == i;
+    }
+    check(ordered, "heap_poll_into returns the minimum each time");
+
+    record *polled = heap_poll(heap, false);
+    check(polled != NULL && polled->key == 100, "heap_poll returns a copy of the minimum");
+    free(polled);
+
+    vector_clear(heap);
+    check(!heap_poll_into(heap, &top, false), "polling an empty heap fails");
+    vector_destroy(heap);
+}
+
+int main() {
+    test_vector_sized_modifiers();
+    test_vector_sized_copies();
+    test_vector_sized_heap();
+    return check_summary("sized Vector");
+}
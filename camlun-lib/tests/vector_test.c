@@ -0,0 +1,459 @@
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+
+#include "vector.h"
+#include "vector_ext.h"
+#include "typemethods.h"
+#include "tuple.h"
+#include "testtools.h"
+
+static type_methods TYPE_INT = TYPE_METHODS(int);
+static type_methods TYPE_STRING = TYPE_METHODS(string);
+
+typedef struct {
+    int key;
+    int order;
+} keyed;
+
+static int keyed_comparator(void *first, void *second) {
+    return VALUE_COMPARE(int, ((keyed *)first)->key, ((keyed *)second)->key);
+}
+
+static size_t keyed_hash(void *ptr) {
+    return numerical_hash_inline(sizeof(keyed), ptr);
+}
+
+static type_methods TYPE_KEYED = {.cmp = keyed_comparator, .hash = keyed_hash};
+
+static type_methods TYPE_DOUBLE = TYPE_METHODS(double);
+static type_methods TYPE_INT8 = TYPE_METHODS(int8_t);
+static type_methods TYPE_UINT64 = TYPE_METHODS(uint64_t);
+static type_methods TYPE_FLOAT = TYPE_METHODS(float);
+
+TUPLE_INIT(static type_methods TYPE_READING, double value; int order;, reading, {
+    return VALUE_COMPARE(double, _first->value, _second->value);
+})
+
+static uint64_t reading_key(void *element) {
+    return radix_key_double(((reading *)element)->value);
+}
+
+void test_vector_copies() {
+    printf("Testing Vector copying modifiers...\n");
+    Vector *vector = vector_create(&TYPE_STRING);
+    char word[8] = "alpha";
+    vector_push_back(vector, word);
+    word[0] = 'A';
+    check(strcmp(vector_get(vector, 0), "alpha") == 0, "push_back stores a copy");
+
+    vector_insert(vector, 0, "beta");
+    vector_set(vector, 1, vector_get(vector, 1));
+    check(strcmp(vector_get(vector, 1), "alpha") == 0, "set copies before releasing the previous element");
+    vector_erase(vector, 0);
+    check(vector_size(vector) == 1 && strcmp(vector_first(vector), "alpha") == 0, "erase removes the element");
+    vector_destroy(vector);
+}
+
+void test_vector_owned() {
+    printf("Testing Vector ownership transfer...\n");
+    Vector *vector = vector_create(&TYPE_STRING);
+    char *first = string_copy_constructor("first");
+    char *second = string_copy_constructor("second");
+    vector_push_back_owned(vector, first);
+    vector_insert_owned(vector, 0, second);
+    vector_push_back_owned(vector, string_copy_constructor("third"));
+    check(vector_get(vector, 0) == second && vector_get(vector, 1) == first, "owned pointers are stored as given");
+
+    vector_set_owned(vector, 2, string_copy_constructor("fourth"));
+    check(strcmp(vector_last(vector), "fourth") == 0, "set_owned replaces the element");
+
+    char *taken = vector_take(vector, 1);
+    check(taken == first && vector_size(vector) == 2, "take hands the element back");
+    check(strcmp(vector_get(vector, 1), "fourth") == 0, "take closes the gap");
+    string_destructor(taken);
+    vector_destroy(vector);
+}
+
+void test_vector_heap_owned() {
+    printf("Testing heaps of owned elements...\n");
+    Vector *heap = vector_create(&TYPE_INT);
+    int *polled_pointers[64];
+    for (int i = 0; i < 64; i++) {
+        int *value = int_copy_constructor(&(int){(i * 23) % 64});
+        polled_pointers[(i * 23) % 64] = value;
+        heap_offer_owned(heap, value, true);
+    }
+
+    bool ordered = true;
+    for (int i = 63; i >= 32; i--) {
+        int *top = heap_poll(heap, true);
+        ordered &= top == polled_pointers[i] && *top == i;
+        int_destructor(top);
+    }
+    check(ordered, "heap_poll returns the offered pointers in order");
+    check(vector_size(heap) == 32, "polls shrink the heap");
+    vector_destroy(heap);
+}
+
+static bool is_multiple(void *data, void *context) {
+    return *(int *)data % *(int *)context == 0;
+}
+
+static bool starts_with(void *data, void *context) {
+    return ((char *)data)[0] == *(char *)context;
+}
+
+void test_vector_ranges() {
+    printf("Testing Vector range operations...\n");
+    Vector *numbers = vector_create_sized(sizeof(int), &TYPE_INT);
+    int first[] = {0, 1, 2, 3, 4, 5, 6, 7, 8, 9};
+    int middle[] = {100, 101, 102};
+    vector_insert_range(numbers, 0, first, 10);
+    vector_insert_range(numbers, 5, middle, 3);
+    check(vector_size(numbers) == 13 && *(int *)vector_get(numbers, 4) == 4 && *(int *)vector_get(numbers, 5) == 100, "insert_range opens a gap");
+    check(*(int *)vector_get(numbers, 8) == 5 && *(int *)vector_last(numbers) == 9, "insert_range shifts the tail once");
+
+    vector_erase_range(numbers, 5, 3);
+    bool restored = vector_size(numbers) == 10;
+    for (int i = 0; restored && i < 10; i++) {
+        restored = *(int *)vector_get(numbers, i) == i;
+    }
+    check(restored, "erase_range closes the gap");
+
+    vector_insert_range(numbers, 2, vector_get(numbers, 0), 10);
+    bool doubled = vector_size(numbers) == 20;
+    for (int i = 0; doubled && i < 20; i++) {
+        doubled = *(int *)vector_get(numbers, i) == (i < 2 ? i : i < 12 ? i - 2 : i - 10);
+    }
+    check(doubled, "insert_range copies a range of the same vector");
+    vector_erase_range(numbers, 2, 10);
+
+    vector_append(numbers, numbers);
+    check(vector_size(numbers) == 20 && *(int *)vector_get(numbers, 15) == 5, "append copies a vector onto itself");
+
+    // A full vector appending a view of its own elements, which reserving moves
+    Vector *full = vector_create_sized(sizeof(int), &TYPE_INT);
+    for (int i = 0; i < 16; i++) {
+        vector_push_back(full, &i);
+    }
+    Vector slice = vector_slice(full, 4, 8);
+    vector_append(full, &slice);
+    bool appended = vector_size(full) == 24;
+    for (int i = 0; appended && i < 24; i++) {
+        appended = *(int *)vector_get(full, i) == (i < 16 ? i : i - 12);
+    }
+    check(appended, "append copies a slice of the same vector");
+    vector_destroy(full);
+
+    int divisor = 3;
+    size_t erased = vector_erase_if(numbers, is_multiple, &divisor);
+    bool kept = erased == 8 && vector_size(numbers) == 12;
+    for (size_t i = 0; kept && i < vector_size(numbers); i++) {
+        kept = *(int *)vector_get(numbers, i) % 3 != 0 && (i == 0 || i == 6 || *(int *)vector_get(numbers, i) > *(int *)vector_get(numbers, i - 1));
+    }
+    check(kept, "erase_if keeps the other elements in order");
+    vector_erase_range(numbers, 0, vector_size(numbers));
+    check(vector_empty(numbers), "erase_range can empty the vector");
+    vector_destroy(numbers);
+
+    Vector *words = vector_create(&TYPE_STRING);
+    char *fruit[] = {"apple", "banana", "avocado", "cherry"};
+    vector_insert_range(words, 0, fruit, 4);
+    Vector *more = vector_create(&TYPE_STRING);
+    vector_push_back(more, "apricot");
+    vector_push_back(more, "date");
+    vector_append(words, more);
+    vector_destroy(more);
+    check(vector_size(words) == 6 && strcmp(vector_get(words, 4), "apricot") == 0, "append copies boxed elements");
+    vector_insert_range(words, 1, words->nodes + 4, 2);
+    check(vector_size(words) == 8 && strcmp(vector_get(words, 1), "apricot") == 0 && strcmp(vector_get(words, 2), "date") == 0 &&
+          vector_get(words, 1) != vector_get(words, 6), "insert_range copies boxed elements of the same vector");
+    vector_erase_range(words, 1, 2);
+
+    char letter = 'a';
+    check(vector_erase_if(words, starts_with, &letter) == 3, "erase_if destroys the erased elements");
+    check(strcmp(vector_first(words), "banana") == 0 && strcmp(vector_last(words), "date") == 0, "erase_if compacts boxed elements");
+    vector_erase_range(words, 1, 1);
+    check(vector_size(words) == 2 && strcmp(vector_get(words, 1), "date") == 0, "erase_range on boxed elements");
+    vector_destroy(words);
+}
+
+static uint32_t next_random(uint32_t *state) {
+    *state ^= *state << 13;
+    *state ^= *state >> 17;
+    *state ^= *state << 5;
+    return *state;
+}
+
+// Element i of an input of size n in the given pattern
+static int sort_input(int pattern, int i, int n, uint32_t *state) {
+    switch (pattern) {
+        case 0:
+            return (int)(next_random(state) % 1000000);
+        case 1:
+            return i;
+        case 2:
+            return n - i;
+        case 3:
+            return (int)(next_random(state) % 8);
+        case 4:
+            // Sorted with a few displaced elements
+            return i % 97 == 0 ? (int)(next_random(state) % (unsigned)n) : i;
+        default:
+            // Organ pipe, rises then falls
+            return i < n / 2 ? i : n - i;
+    }
+}
+
+static bool is_sorted(Vector *vector, bool descending) {
+    for (size_t i = 1; i < vector_size(vector); i++) {
+        int cmp = *(int *)vector_get(vector, i - 1) - *(int *)vector_get(vector, i);
+        if (descending ? cmp < 0 : cmp > 0) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void test_vector_sort() {
+    printf("Testing Vector sorting...\n");
+    int sizes[] = {0, 1, 2, 23, 24, 100, 129, 5000};
+    for (size_t s = 0; s < sizeof(sizes) / sizeof(sizes[0]); s++) {
+        for (int pattern = 0; pattern < 6; pattern++) {
+            for (int variant = 0; variant < 4; variant++) {
+                bool sized = variant & 1;
+                bool descending = variant & 2;
+                Vector *vector = sized ? vector_create_sized(sizeof(int), &TYPE_INT) : vector_create(&TYPE_INT);
+                uint32_t state = 0x2545F491u;
+                long sum = 0;
+                for (int i = 0; i < sizes[s]; i++) {
+                    int value = sort_input(pattern, i, sizes[s], &state);
+                    sum += value;
+                    vector_push_back(vector, &value);
+                }
+                vector_sort(vector, descending);
+                long sorted_sum = 0;
+                for (size_t i = 0; i < vector_size(vector); i++) {
+                    sorted_sum += *(int *)vector_get(vector, i);
+                }
+                checkf(is_sorted(vector, descending) && sorted_sum == sum,
+                       "vector_sort size %d pattern %d variant %d", sizes[s], pattern, variant);
+
+                vector_sort(vector, !descending);
+                checkf(is_sorted(vector, !descending), "vector_sort resort size %d pattern %d variant %d", sizes[s], pattern, variant);
+                vector_destroy(vector);
+            }
+        }
+    }
+}
+
+void test_vector_stable_sort() {
+    printf("Testing Vector stable sorting...\n");
+    for (int descending = 0; descending < 2; descending++) {
+        Vector *vector = vector_create_sized(sizeof(keyed), &TYPE_KEYED);
+        uint32_t state = 0x9E3779B9u;
+        for (int i = 0; i < 3000; i++) {
+            vector_push_back(vector, &(keyed){.key = (int)(next_random(&state) % 50), .order = i});
+        }
+        vector_stable_sort(vector, descending);
+        bool stable = true;
+        for (size_t i = 1; i < vector_size(vector); i++) {
+            keyed *previous = vector_get(vector, i - 1);
+            keyed *current = vector_get(vector, i);
+            if (previous->key == current->key) {
+                stable &= previous->order < current->order;
+            } else {
+                stable &= descending ? previous->key > current->key : previous->key < current->key;
+            }
+        }
+        check(stable, descending ? "stable sort keeps equal keys in order descending" : "stable sort keeps equal keys in order");
+        vector_destroy(vector);
+    }
+
+    Vector *reversed = vector_create_sized(sizeof(int), &TYPE_INT);
+    for (int i = 100; i > 0; i--) {
+        vector_push_back(reversed, &i);
+    }
+    vector_stable_sort(reversed, false);
+    check(is_sorted(reversed, false) && *(int *)vector_first(reversed) == 1, "stable sort reverses descending input");
+    vector_destroy(reversed);
+
+    Vector *words = vector_create(&TYPE_STRING);
+    char *input[] = {"pear", "apple", "fig", "plum", "apple", "kiwi"};
+    for (size_t i = 0; i < sizeof(input) / sizeof(input[0]); i++) {
+        vector_push_back(words, input[i]);
+    }
+    vector_stable_sort(words, false);
+    check(strcmp(vector_first(words), "apple") == 0 && strcmp(vector_last(words), "plum") == 0, "stable sort orders boxed strings");
+    vector_destroy(words);
+
+    // -0.0 and 0.0 compare equal, so they keep their order past the radix threshold too
+    for (int variant = 0; variant < 4; variant++) {
+        Vector *zeros = variant & 1 ? vector_create_sized(sizeof(double), &TYPE_DOUBLE) : vector_create(&TYPE_DOUBLE);
+        for (int i = 0; i < 1024; i++) {
+            vector_push_back(zeros, &(double){i % 2 ? -0.0 : 0.0});
+        }
+        if (variant & 2) {
+            vector_radix_sort(zeros, variant & 1);
+        } else {
+            vector_stable_sort(zeros, variant & 1);
+        }
+        bool kept = true;
+        for (int i = 0; kept && i < 1024; i++) {
+            kept = (signbit(*(double *)vector_get(zeros, i)) != 0) == (i % 2 == 1);
+        }
+        check(kept, variant & 2 ? "radix sort keeps -0.0 and 0.0 in order" : "stable sort keeps -0.0 and 0.0 in order");
+        vector_destroy(zeros);
+    }
+}
+
+void test_vector_radix_sort() {
+    printf("Testing Vector radix sorting...\n");
+    uint32_t state = 0x12345678u;
+    for (int descending = 0; descending < 2; descending++) {
+        Vector *ints = vector_create_sized(sizeof(int), &TYPE_INT);
+        Vector *doubles = vector_create_sized(sizeof(double), &TYPE_DOUBLE);
+        Vector *boxed = vector_create(&TYPE_DOUBLE);
+        Vector *bytes = vector_create_sized(sizeof(int8_t), &TYPE_INT8);
+        Vector *wide = vector_create_sized(sizeof(uint64_t), &TYPE_UINT64);
+        Vector *floats = vector_create(&TYPE_FLOAT);
+        for (int i = 0; i < 3000; i++) {
+            uint32_t r = next_random(&state);
+            vector_push_back(ints, &(int){(int)r});
+            double d = i % 50 == 0 ? -0.0 : ((int)r % 100000) / 7.0;
+            vector_push_back(doubles, &d);
+            vector_push_back(boxed, &d);
+            vector_push_back(bytes, &(int8_t){(int8_t)r});
+            vector_push_back(wide, &(uint64_t){(uint64_t)r << (r % 33)});
+            vector_push_back(floats, &(float){(float)d});
+        }
+        vector_push_back(doubles, &(double){1.0 / 0.0});
+        vector_push_back(doubles, &(double){-1.0 / 0.0});
+
+        // Radix sorts a copy of each, which must come out ordered by the comparator and hold the same elements
+        Vector *vectors[] = {ints, doubles, boxed, bytes, wide, floats};
+        const char *messages[] = {"radix sorts sized ints", "radix sorts sized doubles", "radix sorts boxed doubles",
+                                  "radix sorts sized int8_t", "radix sorts sized uint64_t", "radix sorts boxed floats"};
+        for (size_t v = 0; v < sizeof(vectors) / sizeof(vectors[0]); v++) {
+            Vector *vector = vectors[v];
+            Vector *radix = vector_clone(vector, vector->data_methods);
+            vector_radix_sort(radix, descending);
+            size_t hash_sum = 0;
+            size_t sorted_hash_sum = 0;
+            bool ordered = vector_size(radix) == vector_size(vector);
+            for (size_t i = 0; ordered && i < vector_size(radix); i++) {
+                hash_sum += USE_HASH(vector->data_methods, vector_get(vector, i));
+                sorted_hash_sum += USE_HASH(vector->data_methods, vector_get(radix, i));
+                if (i > 0) {
+                    int cmp = USE_CMP(vector->data_methods, vector_get(radix, i - 1), vector_get(radix, i));
+                    ordered = descending ? cmp >= 0 : cmp <= 0;
+                }
+            }
+            check(ordered && hash_sum == sorted_hash_sum, messages[v]);
+            vector_destroy(radix);
+        }
+
+        vector_sort(ints, descending);
+        check(is_sorted(ints, descending), "vector_sort takes the radix path for large int vectors");
+
+        vector_destroy(ints);
+        vector_destroy(doubles);
+        vector_destroy(boxed);
+        vector_destroy(bytes);
+        vector_destroy(wide);
+        vector_destroy(floats);
+    }
+
+    // Types it cannot key fall back to comparisons
+    Vector *words = vector_create(&TYPE_STRING);
+    vector_push_back(words, "pear");
+    vector_push_back(words, "apple");
+    vector_radix_sort(words, false);
+    check(strcmp(vector_first(words), "apple") == 0, "radix sort falls back for strings");
+    vector_destroy(words);
+}
+
+void test_vector_radix_sort_by() {
+    printf("Testing Vector radix sorting by key...\n");
+    for (int sized = 0; sized < 2; sized++) {
+        Vector *readings = sized ? vector_create_sized(sizeof(reading), &TYPE_READING) : vector_create(&TYPE_READING);
+        uint32_t state = 0xCAFEF00Du;
+        for (int i = 0; i < 2000; i++) {
+            double value = (double)(next_random(&state) % 64) - 32.5;
+            vector_push_back(readings, &(reading){.value = value, .order = i});
+        }
+        vector_radix_sort_by(readings, reading_key, false);
+        bool stable = true;
+        for (size_t i = 1; i < vector_size(readings); i++) {
+            reading *previous = vector_get(readings, i - 1);
+            reading *current = vector_get(readings, i);
+            stable &= previous->value < current->value || (previous->value == current->value && previous->order < current->order);
+        }
+        check(stable, sized ? "radix sort by key orders sized tuples stably" : "radix sort by key orders boxed tuples stably");
+        vector_destroy(readings);
+    }
+}
+
+void test_vector_sort_parallel() {
+    printf("Testing Vector parallel sorting...\n");
+    size_t thread_counts[] = {1, 2, 3, 4, 7};
+    for (size_t t = 0; t < sizeof(thread_counts) / sizeof(thread_counts[0]); t++) {
+        for (int pattern = 0; pattern < 6; pattern++) {
+            bool descending = pattern % 2;
+            Vector *ints = vector_create_sized(sizeof(int), &TYPE_INT);
+            Vector *records = vector_create_sized(sizeof(keyed), &TYPE_KEYED);
+            Vector *boxed = vector_create(&TYPE_INT);
+            uint32_t state = 0xDEADBEEFu;
+            int n = 70001;
+            for (int i = 0; i < n; i++) {
+                int value = sort_input(pattern, i, n, &state);
+                vector_push_back(ints, &value);
+                vector_push_back(records, &(keyed){.key = value, .order = i});
+                if (i < 3 * n / 4) {
+                    vector_push_back(boxed, &value);
+                }
+            }
+
+            // Each must come out ordered by the comparator and hold the same elements
+            Vector *vectors[] = {ints, records, boxed};
+            const char *names[] = {"ints", "records", "boxed ints"};
+            for (size_t v = 0; v < 3; v++) {
+                Vector *vector = vectors[v];
+                size_t hash_sum = 0;
+                for (size_t i = 0; i < vector_size(vector); i++) {
+                    hash_sum += USE_HASH(vector->data_methods, vector_get(vector, i));
+                }
+                vector_sort_parallel(vector, descending, thread_counts[t]);
+                bool ordered = true;
+                for (size_t i = 0; i < vector_size(vector); i++) {
+                    hash_sum -= USE_HASH(vector->data_methods, vector_get(vector, i));
+                    if (i > 0) {
+                        int cmp = USE_CMP(vector->data_methods, vector_get(vector, i - 1), vector_get(vector, i));
+                        ordered &= descending ? cmp >= 0 : cmp <= 0;
+                    }
+                }
+                checkf(ordered && hash_sum == 0, "parallel sort of %s, %zu threads, pattern %d", names[v], thread_counts[t], pattern);
+            }
+
+            vector_destroy(ints);
+            vector_destroy(records);
+            vector_destroy(boxed);
+        }
+    }
+}
+
+int main() {
+    test_vector_copies();
+    test_vector_owned();
+    test_vector_heap_owned();
+    test_vector_ranges();
+    test_vector_sort();
+    test_vector_stable_sort();
+    test_vector_radix_sort();
+    test_vector_radix_sort_by();
+    test_vector_sort_parallel();
+    return check_summary("Vector");
+}